@@ -0,0 +1,143 @@
+/**
+ * Character classes as compile-time tables.
+ */
+
+#ifndef __CHARSET_HPP__
+#define __CHARSET_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+using namespace std;
+
+// A set of characters, as a 256-entry bit table (one bit per byte value). Tables are built at compile time
+// (every operation is `constexpr`) and testing membership is a single lookup, with no locale dependence.
+struct charset_t {
+private:
+    uint64_t bits[4];
+
+    // bits of [lo, hi] that fall in the 64-bit word `w`.
+    static constexpr uint64_t mask(int w, int lo, int hi) {
+        return (lo > hi || hi < w * 64 || lo >= (w + 1) * 64) ? 0 : span(
+            (lo < w * 64 ? 0 : lo - w * 64), (hi >= (w + 1) * 64 ? 63 : hi - w * 64));
+    }
+    static constexpr uint64_t span(int lo, int hi) {
+        return (hi - lo == 63 ? ~uint64_t(0) : ((uint64_t(1) << (hi - lo + 1)) - 1)) << lo;
+    }
+public:
+    constexpr charset_t(): bits{0, 0, 0, 0} {}
+    constexpr charset_t(uint64_t b0, uint64_t b1, uint64_t b2, uint64_t b3): bits{b0, b1, b2, b3} {}
+
+    // all characters in [lo, hi].
+    static constexpr charset_t range(unsigned char lo, unsigned char hi) {
+        return charset_t(mask(0, lo, hi), mask(1, lo, hi), mask(2, lo, hi), mask(3, lo, hi));
+    }
+    // all characters in the null-terminated string `chars`.
+    static constexpr charset_t of(char const *chars) {
+        return *chars ? (range(*chars, *chars) | of(chars + 1)) : charset_t();
+    }
+
+    constexpr bool test(char c) const {
+        return (bits[(unsigned char)c >> 6] >> ((unsigned char)c & 63)) & 1;
+    }
+
+    // union.
+    constexpr charset_t operator | (charset_t const & other) const {
+        return charset_t(bits[0] | other.bits[0], bits[1] | other.bits[1], bits[2] | other.bits[2], bits[3] | other.bits[3]);
+    }
+    // difference.
+    constexpr charset_t operator - (charset_t const & other) const {
+        return charset_t(bits[0] & ~other.bits[0], bits[1] & ~other.bits[1], bits[2] & ~other.bits[2], bits[3] & ~other.bits[3]);
+    }
+    // complement.
+    constexpr charset_t operator ~ () const {
+        return charset_t(~bits[0], ~bits[1], ~bits[2], ~bits[3]);
+    }
+};
+
+// The character classes of <cctype> in the "C" locale.
+constexpr charset_t const digit_set = charset_t::range('0', '9');
+constexpr charset_t const xdigit_set = digit_set | charset_t::range('a', 'f') | charset_t::range('A', 'F');
+constexpr charset_t const upper_set = charset_t::range('A', 'Z');
+constexpr charset_t const lower_set = charset_t::range('a', 'z');
+constexpr charset_t const alpha_set = upper_set | lower_set;
+constexpr charset_t const alnum_set = alpha_set | digit_set;
+constexpr charset_t const blank_set = charset_t::of(" \t");
+constexpr charset_t const space_set = charset_t::of(" \t\n\v\f\r");
+constexpr charset_t const cntrl_set = charset_t::range(0, 31) | charset_t::range(127, 127);
+constexpr charset_t const print_set = charset_t::range(32, 126);
+constexpr charset_t const graph_set = charset_t::range(33, 126);
+
+// Bulk scanner: the length of the longest prefix of a buffer whose characters are all in a class. A class made
+// of a few byte ranges (whitespace, letters and digits, ...) is tested 32 (AVX2) or 16 (SSE2) bytes at a time
+// with vector range compares, other classes and the tail of the buffer go through the table.
+class charset_scanner {
+private:
+    static constexpr int max_ranges = 4;
+    charset_t const cs;
+    int nranges; // -1 when the class has too many ranges for the vector path.
+    unsigned char lo[max_ranges], width[max_ranges];
+public:
+    explicit charset_scanner(charset_t const & cs): cs(cs), nranges(0) {
+        for (int c = 0; c < 256; ++c) {
+            if (!cs.test((char)c)) {
+                continue;
+            }
+            int h = c;
+            while (h + 1 < 256 && cs.test((char)(h + 1))) {
+                h = h + 1;
+            }
+            if (nranges == max_ranges) {
+                nranges = -1;
+                break;
+            }
+            lo[nranges] = (unsigned char)c;
+            width[nranges] = (unsigned char)(h - c);
+            nranges = nranges + 1;
+            c = h;
+        }
+    }
+    charset_t const & charset() const { return this->cs; }
+    size_t span(char const *p, size_t n) const {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; this->nranges > 0 && i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256((__m256i const *)(p + i));
+            __m256i in = _mm256_setzero_si256();
+            for (int r = 0; r < this->nranges; ++r) {
+                // unsigned (x - lo) <= width, i.e. lo <= x <= lo + width.
+                __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8((char)this->lo[r]));
+                in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8((char)this->width[r])), d));
+            }
+            uint32_t out = ~(uint32_t)_mm256_movemask_epi8(in);
+            if (out) {
+                return i + __builtin_ctz(out);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        for (; this->nranges > 0 && i + 16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128((__m128i const *)(p + i));
+            __m128i in = _mm_setzero_si128();
+            for (int r = 0; r < this->nranges; ++r) {
+                __m128i d = _mm_sub_epi8(x, _mm_set1_epi8((char)this->lo[r]));
+                in = _mm_or_si128(in, _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char)this->width[r])), d));
+            }
+            uint32_t out = ~(uint32_t)_mm_movemask_epi8(in) & 0xffff;
+            if (out) {
+                return i + __builtin_ctz(out);
+            }
+        }
+#endif
+        while (i < n && this->cs.test(p[i])) {
+            i = i + 1;
+        }
+        return i;
+    }
+};
+
+#endif /* __CHARSET_HPP__ */
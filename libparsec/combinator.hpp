@@ -10,12 +10,17 @@
 #ifndef __COMBINATOR_HPP__
 #define __COMBINATOR_HPP__
 
+#include <algorithm>
 #include <functional>
 #include <exception>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include "patch.hpp"
 
 #include "input_t.hpp"
+#include "parse_tool.hpp"
 
 using namespace std;
 
@@ -32,17 +37,19 @@ public:
     using parser_type = typename PB::parser_type;
     constexpr compose(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "compose two parser."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t::seq(first_of(pa), first_of(pb)); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
-        if (std::get<0>(res1) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        if (std::get<0>(res1) < 0) {
+            return make_pair(std::get<0>(res1), parser_type());
         }
-        auto res2 = pb(text->drop(std::get<0>(res1)));
-        if (std::get<0>(res2) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        auto res2 = pb(text.drop(std::get<0>(res1)));
+        if (std::get<0>(res2) < 0) {
+            return make_pair(std::get<0>(res2), parser_type());
         }
         else {
-            return make_tuple(std::get<0>(res1) + std::get<0>(res2), std::get<1>(res2), name());
+            return make_pair(std::get<0>(res1) + std::get<0>(res2), std::get<1>(res2));
         }
     }
 };
@@ -61,14 +68,16 @@ public:
     using parser_type = typename PA::parser_type;
     constexpr choice(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "choice from two parser."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t::alt(first_of(pa), first_of(pb)); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
-        if (std::get<0>(res1) != -1) {
-            return make_tuple(std::get<0>(res1), std::get<1>(res1), name());
+        if (std::get<0>(res1) >= 0 || std::get<0>(res1) == committed_failure) { // no backtracking past a cut.
+            return make_pair(std::get<0>(res1), std::get<1>(res1));
         }
         else {
             auto res2 = pb(text);
-            return make_tuple(std::get<0>(res2), std::get<1>(res2), name());
+            return make_pair(std::get<0>(res2), std::get<1>(res2));
         }
     }
 };
@@ -87,14 +96,16 @@ public:
     using parser_type = typename PA::parser_type;
     constexpr try_choice(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "try choice from two parser with backtracking."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t::alt(first_of(pa), first_of(pb)); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
-        if (res1.first != -1) {
-            return make_tuple(std::get<0>(res1), std::get<1>(res1), name());
+        if (std::get<0>(res1) >= 0) { // backtrack on any failure, committed or not.
+            return make_pair(std::get<0>(res1), std::get<1>(res1));
         }
         else {
             auto res2 = pb(text);
-            return make_tuple(std::get<0>(res2), std::get<1>(res2), name());
+            return make_pair(std::get<0>(res2), std::get<1>(res2));
         }
     }
 };
@@ -113,20 +124,19 @@ public:
     using parser_type = pair<typename PA::parser_type, typename PB::parser_type>;
     constexpr joint(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "joint two parser."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
-        string expected;
+    first_t first() const { return first_t::seq(first_of(pa), first_of(pb)); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
-        expected += std::get<2>(res1) + ", ";
-        if (std::get<0>(res1) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        if (std::get<0>(res1) < 0) {
+            return make_pair(std::get<0>(res1), parser_type());
         }
-        auto res2 = pb(text->drop(std::get<0>(res1)));
-        expected += std::get<2>(res2) + ", ";
-        if (std::get<0>(res2) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        auto res2 = pb(text.drop(std::get<0>(res1)));
+        if (std::get<0>(res2) < 0) {
+            return make_pair(std::get<0>(res2), parser_type());
         }
         else {
-            return make_tuple(std::get<0>(res1) + std::get<0>(res2), make_pair(std::get<1>(res1), std::get<1>(res2)), expected);
+            return make_pair(std::get<0>(res1) + std::get<0>(res2), make_pair(std::get<1>(res1), std::get<1>(res2)));
         }
     }
 };
@@ -145,13 +155,15 @@ public:
     using parser_type = typename PA::parser_type;
     constexpr except(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "except one from two parsers."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_of(pa); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
         auto res2 = pb(text);
-        if (std::get<0>(res1) != -1 && std::get<0>(res2) == -1) {
+        if (std::get<0>(res1) >= 0 && std::get<0>(res2) < 0) {
             return res1;
         }
-        return make_tuple(-1, parser_type(), "except " + std::get<2>(res1) + " from " + std::get<2>(res2));
+        return make_pair(std::get<0>(res1) < 0 ? std::get<0>(res1) : -1, parser_type());
     }
 };
 // operator '-'
@@ -169,17 +181,19 @@ public:
     using parser_type = typename PA::parser_type;
     constexpr skip(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "skip the second parser."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t::seq(first_of(pa), first_of(pb)); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
-        if (std::get<0>(res1) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        if (std::get<0>(res1) < 0) {
+            return make_pair(std::get<0>(res1), parser_type());
         }
-        auto res2 = pb(text->drop(std::get<0>(res1)));
-        if (std::get<0>(res2) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        auto res2 = pb(text.drop(std::get<0>(res1)));
+        if (std::get<0>(res2) < 0) {
+            return make_pair(std::get<0>(res2), parser_type());
         }
         // the `skip` combinator DOES consume the end flag. see also `ends_with` combinator.
-        return make_tuple(std::get<0>(res1) + std::get<0>(res2), std::get<1>(res1), name());
+        return make_pair(std::get<0>(res1) + std::get<0>(res2), std::get<1>(res1));
     }
 };
 // operator '<<'
@@ -197,18 +211,20 @@ public:
     using parser_type = typename PA::parser_type;
     constexpr ends_with(PA const & pa, PB const & pb): pa(pa), pb(pb) {}
     string name() const { return "ends with the second parser."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t::seq(first_of(pa), first_of(pb)); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res1 = pa(text);
-        if (std::get<0>(res1) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        if (std::get<0>(res1) < 0) {
+            return make_pair(std::get<0>(res1), parser_type());
         }
-        auto res2 = pb(text->drop(std::get<0>(res1)));
-        if (std::get<0>(res2) == -1) {
-            return make_tuple(-1, parser_type(), name());
+        auto res2 = pb(text.drop(std::get<0>(res1)));
+        if (std::get<0>(res2) < 0) {
+            return make_pair(std::get<0>(res2), parser_type());
         }
         else {
             // the `ends_with` combinator DOES NOT consume the end flag. see also `skip` combinator.
-            return make_tuple(std::get<0>(res1), std::get<1>(res1), name());
+            return make_pair(std::get<0>(res1), std::get<1>(res1));
         }
     }
 };
@@ -218,6 +234,28 @@ constexpr ends_with<PA, PB> const operator < (PA const & pa, PB const & pb) {
     return ends_with<PA, PB>(pa, pb);
 }
 
+// The loop of the repetitions: applies `pa` greedily, `mint` times at least and `maxt` times at most, and moves
+// every result into `sink`. Returns the consumed length, or the failure.
+template<typename PA, typename I, typename F>
+int repeat_loop(PA const & pa, I const & text, int const & mint, int const & maxt, F && sink) {
+    int cnt = 0, offset = 0;
+    I s = text;
+    while (cnt < maxt) {
+        auto res = pa(s);
+        if (get<0>(res) < 0) {
+            if (get<0>(res) == committed_failure) {
+                return committed_failure;
+            }
+            return cnt < mint ? -1 : offset;
+        }
+        sink(cnt, std::move(std::get<1>(res)));
+        cnt = cnt + 1; // update counter.
+        offset = offset + std::get<0>(res); // update length.
+        s = s.drop(std::get<0>(res)); // update text stream.
+    }
+    return offset;
+}
+
 template<typename PA, typename = typename PA::parser_type>
 class times {
 private:
@@ -227,31 +265,80 @@ public:
     using parser_type = vector<typename PA::parser_type>;
     constexpr times(PA const & pa, int const & mint, int const & maxt): pa(pa), mint(mint), maxt(maxt) {}
     string name() const { return "repeat a parser many times."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
-        int cnt = 0, offset = 0;
+    first_t first() const { return first_t{first_of(pa).cs, mint == 0 || first_of(pa).nullable}; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         parser_type actual;
-        string expected;
-        while (cnt < maxt) {
-            auto res = pa(text);
-            if (get<0>(res) == -1) {
-                if (cnt < mint) {
-                    offset = -1; // failed.
-                }
-                break;
-            }
-            cnt = cnt + 1; // update counter.
-            offset = offset + std::get<0>(res); // update length.
-            actual.push_back(std::get<1>(res));
-            expected += std::get<2>(res) + ", ";
-            text = text->drop(std::get<0>(res)); // update text stream.
-            if (cnt >= maxt) {
-                break;
+        int const maxt = this->maxt;
+        int offset = repeat_loop(pa, text, mint, maxt, [&actual, maxt](int cnt, typename PA::parser_type && v) {
+            if (cnt == 0) { // no allocation for an empty repetition.
+                actual.reserve(std::min(maxt, 8));
             }
-        }
-        return make_tuple(offset, actual, expected);
+            actual.push_back(std::move(v));
+        });
+        return make_pair(offset, std::move(actual));
     }
 };
 
+// `many_into(p, out)` repeats `p` zero or more times and writes the results to the output iterator `out` (a
+// `back_inserter` into an existing container for instance) rather than into a new vector, the result is the
+// number of elements written.
+template<typename PA, typename O, typename = typename PA::parser_type>
+class times_into {
+private:
+    PA const pa;
+    O const out;
+    int const mint;
+public:
+    using parser_type = int;
+    times_into(PA const & pa, O const & out, int const & mint): pa(pa), out(out), mint(mint) {}
+    string name() const { return "repeat a parser many times, into an output iterator."; }
+    first_t first() const { return first_t{first_of(pa).cs, mint == 0 || first_of(pa).nullable}; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        O it = this->out;
+        int count = 0;
+        int offset = repeat_loop(pa, text, mint, 0x7fffffff, [&it, &count](int, typename PA::parser_type && v) {
+            *it++ = std::move(v);
+            count = count + 1;
+        });
+        return make_pair(offset, count);
+    }
+};
+template<typename PA, typename O>
+times_into<PA, O> const many_into(PA const & pa, O const & out) {
+    return times_into<PA, O>(pa, out, 0);
+}
+
+// `many_chars(p)` and `many1_chars(p)` repeat a parser of characters and collect them into a string directly.
+template<typename PA, typename = typename PA::parser_type>
+class times_chars {
+private:
+    PA const pa;
+    int const mint;
+public:
+    using parser_type = string;
+    constexpr times_chars(PA const & pa, int const & mint): pa(pa), mint(mint) {}
+    string name() const { return "repeat a parser of characters many times, into a string."; }
+    first_t first() const { return first_t{first_of(pa).cs, mint == 0 || first_of(pa).nullable}; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        string actual;
+        int offset = repeat_loop(pa, text, mint, 0x7fffffff, [&actual](int, typename PA::parser_type && c) {
+            actual.push_back(c);
+        });
+        return make_pair(offset, std::move(actual));
+    }
+};
+template<typename PA>
+constexpr times_chars<PA> const many_chars(PA const & pa) {
+    return times_chars<PA>(pa, 0);
+}
+template<typename PA>
+constexpr times_chars<PA> const many1_chars(PA const & pa) {
+    return times_chars<PA>(pa, 1);
+}
+
 template<typename PA, typename = typename PA::parser_type>
 struct optional {
 private:
@@ -260,10 +347,12 @@ public:
     using parser_type = typename PA::parser_type;
     constexpr optional(PA const & pa): pa(pa) {}
     string name() const { return "optional: repeat 0 or 1 times."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t{first_of(pa).cs, true}; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res = pa(text);
         if (std::get<0>(res) == -1) {
-            return make_tuple(0, parser_type(), name());
+            return make_pair(0, parser_type());
         }
         else {
             return res;
@@ -276,6 +365,104 @@ constexpr optional<PA> const operator ~ (PA const & pa) {
     return optional<PA>(pa);
 }
 
+// `commit p` is a cut point: once the parser before it has matched, the alternatives are settled and a failure
+// of `p` is committed (the failure after consumed input of Parsec). `|`, `dispatch` and the repetitions don't
+// try other alternatives after a committed failure, they fail with it at once; only `^` still backtracks.
+template<typename PA, typename = typename PA::parser_type>
+class committed {
+private:
+    PA const pa;
+public:
+    using parser_type = typename PA::parser_type;
+    constexpr committed(PA const & pa): pa(pa) {}
+    string name() const { return "commit: no backtracking on failure."; }
+    first_t first() const { return first_of(pa); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        auto res = pa(text);
+        if (std::get<0>(res) < 0) {
+            return make_pair(committed_failure, parser_type());
+        }
+        return res;
+    }
+};
+template<typename PA>
+constexpr committed<PA> const commit(PA const & pa) {
+    return committed<PA>(pa);
+}
+
+// `profile(p, name)` counts the invocations of `p` under `name` when profiling is enabled (see profile.hpp), and
+// is `p` itself otherwise.
+#ifdef ENABLE_PROFILE
+template<typename P, typename = typename P::parser_type>
+class profiled {
+private:
+    P const p;
+    profile_stat_t *const stat;
+public:
+    using parser_type = typename P::parser_type;
+    profiled(P const & p, string const & name): p(p), stat(profiler::instance().stat(name)) {}
+    string name() const { return this->p.name(); }
+    first_t first() const { return first_of(p); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        profile_scope_t scope(this->stat);
+        auto res = p(text);
+        scope.finish(text.width(std::get<0>(res)));
+        return res;
+    }
+};
+template<typename P>
+profiled<P> const profile(P const & p, string const & name) {
+    return profiled<P>(p, name);
+}
+#else
+template<typename P>
+P const profile(P const & p, string const &) {
+    return p;
+}
+#endif
+
+// `recover(p, sync)` is panic-mode error recovery: when `p` fails past a cut point, the error is reported to the
+// stream and the input is skipped up to the next position where `sync` matches (at least one element is skipped,
+// the match of `sync` isn't consumed); the result is then a success with a default value. A plain failure of `p`
+// isn't an error yet, it's returned as is.
+template<typename P, typename S, typename = typename P::parser_type>
+class recovery {
+private:
+    P const p;
+    S const sync;
+    string const message;
+public:
+    using parser_type = typename P::parser_type;
+    recovery(P const & p, S const & sync, string const & message): p(p), sync(sync), message(message) {}
+    string name() const { return "recover: " + message; }
+    first_t first() const { return first_of(p); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        auto res = p(text);
+        if (std::get<0>(res) != committed_failure || text.empty()) {
+            return res;
+        }
+        text.report(this->message);
+        I s = text.drop(1);
+        int skipped = 1;
+        while (!s.empty() && std::get<0>(sync(s)) < 0) {
+            s = s.drop(1);
+            skipped = skipped + 1;
+        }
+        return make_pair(skipped, parser_type());
+    }
+};
+template<typename P, typename S>
+recovery<P, S> const recover(P const & p, S const & sync, string const & message) {
+    return recovery<P, S>(p, sync, message);
+}
+template<typename P, typename S>
+recovery<P, S> const recover(P const & p, S const & sync) {
+    return recovery<P, S>(p, sync, "syntax error, " + p.name());
+}
+
 template<typename PA, typename = typename PA::parser_type>
 struct many {
 private:
@@ -284,7 +471,9 @@ public:
     using parser_type = vector<typename PA::parser_type>;
     constexpr many(PA const & pa): pa(pa) {}
     string name() const { return "many: repeat 0 or more times."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t{first_of(pa).cs, true}; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         return times<PA>(pa, 0, 0x7fffffff)(text);
     }
 };
@@ -302,7 +491,9 @@ public:
     using parser_type = vector<typename PA::parser_type>;
     constexpr many1(PA const & pa): pa(pa) {}
     string name() const { return "many1: repeat 1 or more times."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_of(pa); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         return times<PA>(pa, 1, 0x7fffffff)(text);
     }
 };
@@ -321,7 +512,9 @@ public:
     using parser_type = vector<typename PA::parser_type>;
     constexpr countk(PA const & pa, const int & k): pa(pa), k(k) {}
     string name() const { return "countk: repeat exactly k times."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_t{first_of(pa).cs, k == 0 || first_of(pa).nullable}; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         return times<PA>(pa, k, k)(text);
     }
 };
@@ -341,13 +534,38 @@ public:
     using parser_type = vector<typename P::parser_type>;
     constexpr sepby1(P const & p, SEP const & sep): p(p), sep(sep) {}
     string name() const { return "one or more occurrences of p, separated by sep."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
-        auto res = (p + (++(sep >> p)))(text);
-        string description = std::get<2>(res);
-        parser_type vec = std::get<1>(res).second;
-        auto firstp = std::get<1>(res).first;
-        vec.insert(vec.begin(), firstp);
-        return make_tuple(std::get<0>(res), vec, description);
+    first_t first() const { return first_of(p); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        parser_type vec;
+        auto res = p(text);
+        if (std::get<0>(res) < 0) {
+            return make_pair(std::get<0>(res), std::move(vec));
+        }
+        vec.reserve(4);
+        vec.push_back(std::move(std::get<1>(res)));
+        int offset = std::get<0>(res);
+        I s = text.drop(offset);
+        while (true) { // appends (sep >> p) in place.
+            auto res1 = sep(s);
+            if (std::get<0>(res1) < 0) {
+                if (std::get<0>(res1) == committed_failure) {
+                    return make_pair(committed_failure, parser_type());
+                }
+                break;
+            }
+            auto res2 = p(s.drop(std::get<0>(res1)));
+            if (std::get<0>(res2) < 0) {
+                if (std::get<0>(res2) == committed_failure) {
+                    return make_pair(committed_failure, parser_type());
+                }
+                break;
+            }
+            vec.push_back(std::move(std::get<1>(res2)));
+            offset = offset + std::get<0>(res1) + std::get<0>(res2);
+            s = s.drop(std::get<0>(res1) + std::get<0>(res2));
+        }
+        return make_pair(offset, std::move(vec));
     }
 };
 // operator '%'
@@ -356,26 +574,265 @@ constexpr sepby1<P, SEP> const operator % (P const & p, SEP const & sep) {
     return sepby1<P, SEP>(p, sep);
 }
 
-template<typename PA, typename T, typename = typename PA::parser_type>
+// `mapfn p fn` applies `fn` to the result of `p`. `fn` can be any callable object, it's kept with its own type
+// (rather than as a `std::function`) so that the call can be inlined.
+template<typename PA, typename T, typename F = function<T (typename PA::parser_type)>>
 class mapfn {
 public:
     using parser_type = T;
     using origin_type = typename PA::parser_type;
 private:
     PA const pa;
-    function<parser_type (origin_type)> const fn;
+    F const fn;
 public:
-    constexpr mapfn(PA const & pa, function<parser_type (origin_type)> const & fn): pa(pa), fn(fn) {}
+    constexpr mapfn(PA const & pa, F const & fn): pa(pa), fn(fn) {}
     string name() const { return "apply a function to the result"; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_of(pa); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto res = pa(text);
-        return make_tuple(std::get<0>(res), fn(std::get<1>(res)), "map fn on " + name());
+        return make_pair(std::get<0>(res), fn(std::get<1>(res)));
     }
 };
 // operator '/'
-template<typename PA, typename T>
-constexpr mapfn<PA, T> const operator / (PA const & pa, function<T(typename PA::parser_type)> const & fn) {
-    return mapfn<PA, T>(pa, fn);
+template<typename PA, typename F, typename T = typename result_of<F (typename PA::parser_type)>::type>
+constexpr mapfn<PA, T, F> const operator / (PA const & pa, F const & fn) {
+    return mapfn<PA, T, F>(pa, fn);
+}
+
+// `memo p` memoizes the result of `p` at every offset of the input (packrat parsing), so that `p`
+// is applied at most once per position during a parse. The memo table belongs to the input source.
+// A `memo` object must be constructed once and shared (e.g. a static object or a copy) for its
+// results to be reused, since every constructed `memo` has its own key. Named parsers (`parser_t`)
+// can be memoized directly with their `memoized` flag instead.
+template<typename PA, typename = typename PA::parser_type>
+class memoize {
+private:
+    PA const pa;
+    size_t const uid;
+public:
+    using parser_type = typename PA::parser_type;
+    memoize(PA const & pa): pa(pa), uid(parsec_uid()) {}
+    string name() const { return "memo: packrat memoization of a parser."; }
+    first_t first() const { return first_of(pa); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        result_t<parser_type> const *hit = text.template recall<result_t<parser_type>>(this->uid);
+        if (hit) {
+            return *hit;
+        }
+        result_t<parser_type> res = pa(text);
+        text.remember(this->uid, res);
+        return res;
+    }
+};
+template<typename PA>
+memoize<PA> const memo(PA const & pa) {
+    return memoize<PA>(pa);
+}
+
+// An alternative of `dispatch`: a parser with the key that predicts it, either the set of characters its
+// match starts with or the words its match starts with (a word is a run of letters and digits).
+template<typename P>
+struct alternative_t {
+    P const p;
+    charset_t const chars;
+    vector<string> const words;
+    bool const always; // may match the empty string, always tried.
+};
+// key: the FIRST set of `p`, derived from the combinator tree.
+template<typename P>
+alternative_t<P> const alt(P const & p) {
+    first_t first = first_of(p);
+    return alternative_t<P>{p, first.cs, vector<string>(), first.nullable};
+}
+// key: the first character.
+template<typename P>
+alternative_t<P> const alt(charset_t const & chars, P const & p) {
+    return alternative_t<P>{p, chars, vector<string>(), false};
+}
+// key: the first word.
+template<typename P>
+alternative_t<P> const alt(initializer_list<string> const & words, P const & p) {
+    return alternative_t<P>{p, charset_t(), vector<string>(words), false};
+}
+
+// `dispatch<T>(skip, alt(...), ...)` is a predictive choice: it looks at the first character (and the first
+// word) after the characters in `skip`, without consuming them, and only tries the alternatives whose key
+// matches, in the order they are given. The result of the first one that succeeds is converted to `T`. When
+// the keys are disjoint, that's a single LL(1) step instead of trying every alternative in turn. Over a token
+// stream the word is the next token and the first character is the first one of its text (`skip` is unused).
+template<typename T, typename... A>
+class dispatcher {
+private:
+    static_assert(sizeof...(A) <= 32, "dispatch: at most 32 alternatives.");
+    tuple<A...> const alts;
+    charset_scanner const skip;
+    charset_scanner const word;
+    uint32_t by_char[257]; // alternatives to try for each first character, [256] at the end of input.
+    vector<pair<string, uint32_t>> by_word; // alternatives to try for each first word.
+
+    template<size_t I>
+    void index(integral_constant<size_t, I>) {
+        auto const & a = std::get<I>(this->alts);
+        for (int c = 0; c < 257; ++c) {
+            if (a.always || (c < 256 && a.chars.test((char)c))) {
+                this->by_char[c] |= uint32_t(1) << I;
+            }
+        }
+        for (string const & w: a.words) {
+            auto iter = std::find_if(this->by_word.begin(), this->by_word.end(), [&](pair<string, uint32_t> const & e) { return e.first == w; });
+            if (iter == this->by_word.end()) {
+                this->by_word.emplace_back(w, uint32_t(1) << I);
+            }
+            else {
+                iter->second |= uint32_t(1) << I;
+            }
+        }
+        this->index(integral_constant<size_t, I + 1>());
+    }
+    void index(integral_constant<size_t, sizeof...(A)>) {}
+
+    template<typename S, size_t I>
+    result_t<T> attempt(uint32_t candidates, S const & text, integral_constant<size_t, I>) const {
+        if ((candidates >> I) & 1) {
+            auto res = std::get<I>(this->alts).p(text);
+            if (std::get<0>(res) >= 0) {
+                return make_pair(std::get<0>(res), T(std::get<1>(res)));
+            }
+            if (std::get<0>(res) == committed_failure) {
+                return make_pair(committed_failure, T());
+            }
+        }
+        return this->attempt(candidates, text, integral_constant<size_t, I + 1>());
+    }
+    template<typename S>
+    result_t<T> attempt(uint32_t, S const &, integral_constant<size_t, sizeof...(A)>) const {
+        return make_pair(-1, T());
+    }
+
+    // the alternatives whose key matches the word `w` starting with the character `c`.
+    uint32_t predict(char c, slice_t const & w) const {
+        uint32_t candidates = this->by_char[(unsigned char)c];
+        for (auto const & e: this->by_word) {
+            if (w == e.first) { candidates |= e.second; }
+        }
+        return candidates;
+    }
+    // over characters: the first character after the skipped ones, and the run of letters and digits from it.
+    uint32_t predict(input_t const & text) const {
+        slice_t rest = text.take(text.length());
+        size_t k = this->skip.span(rest.ptr, rest.len);
+        if (k == rest.len) {
+            return this->by_char[256];
+        }
+        return this->predict(rest.ptr[k], this->by_word.empty() ? slice_t() : slice_t(rest.ptr + k, this->word.span(rest.ptr + k, rest.len - k)));
+    }
+    // over tokens: the first character of the next token, and the token itself as the word.
+    template<typename L>
+    uint32_t predict(token_input_t<L> const & text) const {
+        if (text.empty() || text.at(0).text.empty()) {
+            return this->by_char[256];
+        }
+        return this->predict(text.at(0).text.ptr[0], text.at(0).text);
+    }
+public:
+    using parser_type = T;
+    dispatcher(charset_t const & skip, A const &... alts): alts(alts...), skip(skip), word(alnum_set), by_char() {
+        this->index(integral_constant<size_t, 0>());
+    }
+    string name() const { return "dispatch on the first character or word."; }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        return this->attempt(this->predict(text), text, integral_constant<size_t, 0>());
+    }
+};
+template<typename T, typename... A>
+dispatcher<T, A...> const dispatch(charset_t const & skip, A const &... alts) {
+    return dispatcher<T, A...>(skip, alts...);
+}
+
+// An entry of an operator table: the precedence of the operator (the higher, the tighter it binds, 0 when the
+// operator doesn't belong to the table) and whether it's right associative.
+struct op_level_t {
+    int prec;
+    bool right;
+};
+// Operator table of `precedence`: the levels of the operators, by a key of the operator.
+template<typename K>
+struct op_table_t {
+private:
+    vector<pair<K, op_level_t>> const levels;
+public:
+    op_table_t(initializer_list<pair<K, op_level_t>> const & levels): levels(levels) {}
+    op_level_t operator () (K const & k) const {
+        for (auto const & e: this->levels) {
+            if (e.first == k) { return e.second; }
+        }
+        return op_level_t{0, false};
+    }
+};
+
+// `precedence p op level fold` parses an expression of operands `p` and binary operators `op` by precedence
+// climbing (the table-driven `buildExpressionParser` of Parsec): `level` gives the precedence and associativity
+// of an operator (see `op_level_t` and `op_table_t`) and `fold(lhs, op, rhs)` combines two operands into one.
+// Operators are folded as soon as their right operand is complete, in a single loop per precedence level in
+// use, so no list of (operator, operand) pairs is built. An operator that isn't in the table, or that isn't
+// followed by an operand, ends the expression without being consumed.
+template<typename P, typename OP, typename L, typename F, typename = typename P::parser_type, typename = typename OP::parser_type>
+class precedence_parser {
+private:
+    P const p;
+    OP const op;
+    L const level;
+    F const fold;
+
+    template<typename I>
+    result_t<typename P::parser_type> climb(I const & text, int const minprec) const {
+        auto lhs = p(text);
+        if (std::get<0>(lhs) < 0) {
+            return lhs;
+        }
+        I s = text.drop(std::get<0>(lhs));
+        while (!s.empty()) {
+            auto res1 = op(s);
+            if (std::get<0>(res1) == committed_failure) {
+                return make_pair(committed_failure, typename P::parser_type());
+            }
+            if (std::get<0>(res1) < 0) {
+                break;
+            }
+            op_level_t l = level(std::get<1>(res1));
+            if (l.prec <= 0 || l.prec < minprec) {
+                break;
+            }
+            // the right operand binds the operators tighter than this one (or as tight, when right associative).
+            auto res2 = this->climb(s.drop(std::get<0>(res1)), l.right ? l.prec : l.prec + 1);
+            if (std::get<0>(res2) == committed_failure) {
+                return res2;
+            }
+            if (std::get<0>(res2) < 0) {
+                break;
+            }
+            std::get<1>(lhs) = fold(std::get<1>(lhs), std::get<1>(res1), std::get<1>(res2));
+            std::get<0>(lhs) += std::get<0>(res1) + std::get<0>(res2);
+            s = s.drop(std::get<0>(res1) + std::get<0>(res2));
+        }
+        return lhs;
+    }
+public:
+    using parser_type = typename P::parser_type;
+    precedence_parser(P const & p, OP const & op, L const & level, F const & fold): p(p), op(op), level(level), fold(fold) {}
+    string name() const { return "expression by precedence climbing."; }
+    first_t first() const { return first_of(p); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        return this->climb(text, 1);
+    }
+};
+template<typename P, typename OP, typename L, typename F>
+precedence_parser<P, OP, L, F> const precedence(P const & p, OP const & op, L const & level, F const & fold) {
+    return precedence_parser<P, OP, L, F>(p, op, level, fold);
 }
 
 // `chainl p op x` parser one or more occurrences of p, separated by op Returns a value
@@ -392,33 +849,45 @@ public:
     using parser_type = vector<element_type>;
     constexpr chainl(P const & p, OP const & op): p(p), op(op) {}
     string name() const { return "chainl combinator, to handle left-recursive grammars."; }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
+    first_t first() const { return first_of(p); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
         auto result = parser_type();
         int length = 0;
         
         auto res1 = p(text);
-        if (std::get<0>(res1) == -1) { // parser the first left value.
-            return make_tuple(-1, result, name());
+        if (std::get<0>(res1) < 0) { // parser the first left value.
+            return make_pair(std::get<0>(res1), result);
         }
         length = std::get<0>(res1);
-        text = text->drop(std::get<0>(res1));
+        I s = text.drop(std::get<0>(res1));
         element_type e = element_type();
         e.second = std::get<1>(res1);
         result.emplace_back(e);
         
         // parser the other values.
-        while (!text->empty()) {
-            auto res = (op + p)(text);
-            if (std::get<0>(res) == -1) {
+        while (!s.empty()) {
+            auto res2 = op(s);
+            if (std::get<0>(res2) == committed_failure) {
+                return make_pair(committed_failure, parser_type());
+            }
+            if (std::get<0>(res2) < 0) {
                 break;
             }
-            length += std::get<0>(res);
-            text = text->drop(std::get<0>(res));
-            result.emplace_back(std::get<1>(res));
+            auto res3 = p(s.drop(std::get<0>(res2)));
+            if (std::get<0>(res3) == committed_failure) {
+                return make_pair(committed_failure, parser_type());
+            }
+            if (std::get<0>(res3) < 0) {
+                break;
+            }
+            length += std::get<0>(res2) + std::get<0>(res3);
+            s = s.drop(std::get<0>(res2) + std::get<0>(res3));
+            result.emplace_back(std::get<1>(res2), std::get<1>(res3));
         }
 
         // finish.
-        return make_tuple(length, result, name());
+        return make_pair(length, result);
     }
 };
 // operator ">="
@@ -427,52 +896,34 @@ constexpr chainl<P, OP> const operator >= (P const & p, OP const & op) {
     return chainl<P, OP>(p, op);
 }
 
-// chainr p op x parser one or more occurrences of |p|, separated by op Returns a value obtained by a 
-// **right associative** application of all functions returned by op to the values returned by p.
+// `chainr p op` parses one or more occurrences of `p`, separated by `op`, and returns the value obtained by a
+// **right associative** application of the functions returned by `op` to the values returned by `p` (the
+// `chainr1` of Parsec), i.e. an expression of a single right associative precedence level.
 template<typename P, typename OP, typename = typename P::parser_type, typename = typename OP::parser_type>
 struct chainr {
-    // TODO: not implemented.
 private:
-    P const p;
-    OP const op;
+    using T = typename P::parser_type;
+    using O = typename OP::parser_type;
+    struct level_fn {
+        op_level_t operator () (O const &) const { return op_level_t{1, true}; }
+    };
+    struct fold_fn {
+        T operator () (T const & lhs, O const & f, T const & rhs) const { return f(lhs, rhs); }
+    };
+    precedence_parser<P, OP, level_fn, fold_fn> const parser;
 public:
-    using element_type = ::pair<typename OP::parser_type, typename P::parser_type>;
-    using parser_type = vector<element_type>;
-    constexpr chainr(P const & p, OP const & op): p(p), op(op) {}
-    string name() const { return "chainl combinator, to handle right-recursive grammars."; }
-    tuple<int, parser_type const, string const> operator () (string const & text) const {
-        auto result = parser_type();
-        string s = text;
-        int length = 0;
-        
-        auto res1 = p(s);
-        if (res1.first == -1) { // parser the first left value.
-            return make_pair(-1, result, name());
-        }
-        length = res1.first;
-        s = drop(s, res1.first);
-        element_type e = element_type();
-        e.second = res1.second.first;
-        result.emplace_back(e);
-        
-        // parser the other values.
-        while (!s.empty()) {
-            auto res = (op + p)(s);
-            if (std::get<0>(res) == -1) {
-                break;
-            }
-            length += std::get<0>(res);
-            s = drop(s, std::get<0>(res));
-            result.emplace_back(res.second.first);
-        }
-
-        // finish.
-        return make_tuple(length, result, name());
+    using parser_type = T;
+    chainr(P const & p, OP const & op): parser(p, op, level_fn(), fold_fn()) {}
+    string name() const { return "chainr combinator, to handle right-recursive grammars."; }
+    first_t first() const { return parser.first(); }
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        return this->parser(text);
     }
 };
 // operator "<="
 template<typename P, typename OP>
-constexpr chainr<P, OP> const operator <= (P const & p, OP const & op) {
+chainr<P, OP> const operator <= (P const & p, OP const & op) {
     return chainr<P, OP>(p, op);
 }
 
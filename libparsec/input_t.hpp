@@ -2,62 +2,238 @@
 #define __INPUT_T_HPP__
 
 #include <iostream>
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <cstring>
+#include <vector>
 #include "patch.hpp"
 
 using namespace std;
 
+// A non-owning view of a piece of text in the input stream, valid as long as any `input_t`
+// over the same source is alive.
+struct slice_t {
+    char const *ptr;
+    size_t len;
+    slice_t(): ptr(nullptr), len(0) {}
+    slice_t(char const *ptr, size_t len): ptr(ptr), len(len) {}
+    size_t length() const { return this->len; }
+    bool empty() const { return this->len == 0; }
+    string str() const { return string(this->ptr, this->len); }
+    bool operator == (string const & s) const { return s.length() == len && (len == 0 || ::memcmp(s.data(), ptr, len) == 0); }
+    bool operator != (string const & s) const { return !(*this == s); }
+    friend bool operator == (string const & s, slice_t const & v) { return v == s; }
+    friend bool operator != (string const & s, slice_t const & v) { return v != s; }
+};
+
+// Unique id of a parser, used as the key of memoized results (see the `memo` combinator).
+inline size_t parsec_uid() {
+    static size_t uid = 0;
+    return ++uid;
+}
+
+// Key of the packrat memo tables: (parser uid, offset in the stream).
+struct memo_key_hash {
+    size_t operator () (pair<size_t, size_t> const & k) const { return (k.first * 0x9e3779b97f4a7c15ull) ^ k.second; }
+};
+
+// A syntax error that the parser has recovered from (see the `recover` combinator).
+struct diagnostic_t {
+    pair<int, int> loc;
+    string message;
+};
+
 // Input stream model.
+//
+// An input stream is a lightweight view over an immutable source text: the text is shared by
+// all streams derived from the same source, and a stream is just an offset into it. `drop`,
+// `next`, `take` and `at` never copy the text. Source locations are not tracked while parsing,
+// the source builds a table of line-start offsets once when it's loaded and `locate()` finds the
+// line of an offset by binary search over that table.
+//
+// The source also owns the memo table for packrat parsing, so memoized results live exactly as
+// long as the parse over that source, and the diagnostics of the errors recovered from.
 
 struct input_t {
 private:
-    string const & desc;
-    int line, column;
-    string text;
+    struct source_t {
+        string const text;
+        string const desc;
+        int const line, column; // location of the first character.
+        vector<size_t> lines; // offsets of the first character of every line.
+        mutable unordered_map<pair<size_t, size_t>, shared_ptr<void const>, memo_key_hash> memo; // (parser uid, offset) -> result.
+        mutable vector<diagnostic_t> diagnostics;
+        source_t(string const & text, int line, int column, string const & desc)
+            : text(text), desc(desc), line(line), column(column) {
+            lines.emplace_back(0);
+            for (size_t i = text.find('\n'); i != text.npos; i = text.find('\n', i + 1)) {
+                lines.emplace_back(i + 1);
+            }
+        }
+        pair<int, int> locate(size_t offset) const {
+            size_t l = upper_bound(lines.begin(), lines.end(), offset) - lines.begin() - 1;
+            int c = (int)(offset - lines[l]) + 1;
+            return make_pair(line + (int)l, l == 0 ? (column + c - 1) : c);
+        }
+    };
+    shared_ptr<source_t const> src;
+    size_t offset;
+
+    input_t(shared_ptr<source_t const> const & src, size_t offset): src(src), offset(offset) {}
 public:
-    input_t(string const text, int line = 1, int column = 1, string const & desc = "unknown input stream"): desc(desc), line(line), column(column), text(text) {}
+    input_t(string const & text, int line = 1, int column = 1, string const & desc = "unknown input stream")
+        : src(make_shared<source_t>(text, line, column, desc)), offset(0) {}
     ~input_t() {}
-    input_t *next(int const & k) { return this->drop(k); }
-    bool empty() const { return this->text.empty(); }
-    char at(int const & k) { return this->text.at(k); }
-    input_t *drop(int const & k) {
+    input_t next(int const & k) const { return this->drop(k); }
+    bool empty() const { return this->offset >= this->src->text.length(); }
+    char at(int const & k) const { return this->src->text.at(this->offset + k); }
+    input_t drop(int const & k) const {
         if (k < 0) {
             // cout <<  string("ERROR: try to drop ") << k << " chars from input stream." << endl;
-            return this;
+            return *this;
         }
-        int l = line, c = column;
-        size_t len = min((size_t)k, text.length());
-        for (size_t i = 0; i < len; ++i) {
-            if (text.at(i) == '\n') {
-                l = l + 1; c = 1;
-            }
-            else {
-                c = c + 1;
-            }
-        }
-        if ((size_t)k < this->text.length()) {
-            return new input_t(this->text.substr(k), l, c, this->desc);
-        }
-        return new input_t("", l, c, this->desc);
+        return input_t(this->src, this->offset + min(k, this->length()));
     }
-    string take(int const & k) {
-        if ((size_t)k <= this->text.length()) {
-            return this->text.substr(0, k);
+    slice_t take(int const & k) const {
+        if (k >= 0 && k <= this->length()) {
+            return slice_t(this->src->text.data() + this->offset, k);
         }
-        return string();
+        return slice_t();
     }
-    int length() { return this->text.length(); }
-    string extract() { cout << "this->text: " << this->text << endl; return this->text; }
+    int length() const { return this->src->text.length() - this->offset; }
+    // number of source characters covered by the next `k` elements of the stream.
+    int width(int const & k) const { return k; }
+    string extract() const { string rest = this->src->text.substr(this->offset); cout << "this->text: " << rest << endl; return rest; }
 
     // overload stringstream operator.
     friend std::ostream & operator << (std::ostream & out, input_t const & t) {
-        out << t.text << endl;
+        out.write(t.src->text.data() + t.offset, t.length());
+        out << endl;
         return out;
     }
 
+    // packrat memoization: look up/record the result of parser `uid` at the current offset.
+    template<typename R>
+    R const *recall(size_t const & uid) const {
+        auto iter = this->src->memo.find(make_pair(uid, this->offset));
+        return iter == this->src->memo.end() ? nullptr : static_cast<R const *>(iter->second.get());
+    }
+    template<typename R>
+    void remember(size_t const & uid, R const & res) const {
+        this->src->memo[make_pair(uid, this->offset)] = make_shared<R const>(res);
+    }
+
+    // record a syntax error at the current offset, parsing goes on.
+    void report(string const & message) const {
+        this->src->diagnostics.emplace_back(diagnostic_t{this->locate(), message});
+    }
+    vector<diagnostic_t> const & diagnostics() const {
+        return this->src->diagnostics;
+    }
+
     // get current location of the stream.
-    pair<int, int> locate() {
-        return make_pair(this->line, this->column);
+    pair<int, int> locate() const {
+        return this->src->locate(this->offset);
+    }
+    // location of the character `k` characters ahead.
+    pair<int, int> locate(size_t const & k) const {
+        return this->src->locate(this->offset + k);
+    }
+    // offset of the current character in the source, a compact location that `locate_position` decodes.
+    size_t position() const {
+        return this->offset;
+    }
+    pair<int, int> locate_position(size_t const & position) const {
+        return this->src->locate(position);
+    }
+};
+
+// A token: its kind (an enumeration of the lexer), its text and the offset of the text in the source, relative
+// to the position where the lexer started.
+struct token_t {
+    int kind;
+    slice_t text;
+    size_t offset;
+};
+
+// Token stream model.
+//
+// The same interface as `input_t`, but the elements of the stream are tokens rather than characters, so the
+// combinators can be applied to either kind of stream. The lexer `L` (a type with a static function
+// `vector<token_t> lex(input_t const &)`) splits the source into tokens in a single pass when the stream is
+// constructed from a character stream; whitespace and other separators are dropped at that point, so a parser
+// over tokens never scans them again. Lengths and memo keys are counted in tokens, `width` maps a number of
+// tokens back to source characters and `locate` reports the location of the current token.
+
+template<typename L>
+struct token_input_t {
+private:
+    struct source_t {
+        input_t const text;
+        vector<token_t> const tokens;
+        mutable unordered_map<pair<size_t, size_t>, shared_ptr<void const>, memo_key_hash> memo; // (parser uid, token index) -> result.
+        source_t(input_t const & text): text(text), tokens(L::lex(text)) {}
+        // source offset of the token `k`, or the end of the source.
+        size_t start(size_t k) const {
+            return k < tokens.size() ? tokens[k].offset : (size_t)text.length();
+        }
+    };
+    shared_ptr<source_t const> src;
+    size_t offset;
+
+    token_input_t(shared_ptr<source_t const> const & src, size_t offset): src(src), offset(offset) {}
+public:
+    explicit token_input_t(input_t const & text): src(make_shared<source_t>(text)), offset(0) {}
+    ~token_input_t() {}
+    token_input_t next(int const & k) const { return this->drop(k); }
+    bool empty() const { return this->offset >= this->src->tokens.size(); }
+    token_t const & at(int const & k) const { return this->src->tokens.at(this->offset + k); }
+    token_input_t drop(int const & k) const {
+        if (k < 0) {
+            return *this;
+        }
+        return token_input_t(this->src, this->offset + min(k, this->length()));
+    }
+    int length() const { return this->src->tokens.size() - this->offset; }
+    // the stream starts at the beginning of the source (leading whitespace included) and a token covers the
+    // separators that follow it.
+    int width(int const & k) const {
+        if (k < 0) {
+            return k;
+        }
+        size_t begin = this->offset == 0 ? 0 : this->src->start(this->offset);
+        return (int)(this->src->start(this->offset + min(k, this->length())) - begin);
+    }
+
+    template<typename R>
+    R const *recall(size_t const & uid) const {
+        auto iter = this->src->memo.find(make_pair(uid, this->offset));
+        return iter == this->src->memo.end() ? nullptr : static_cast<R const *>(iter->second.get());
+    }
+    template<typename R>
+    void remember(size_t const & uid, R const & res) const {
+        this->src->memo[make_pair(uid, this->offset)] = make_shared<R const>(res);
+    }
+
+    // diagnostics are kept by the character stream, at the location of the current token.
+    void report(string const & message) const {
+        this->src->text.drop(this->src->start(this->offset)).report(message);
+    }
+    vector<diagnostic_t> const & diagnostics() const {
+        return this->src->text.diagnostics();
+    }
+
+    pair<int, int> locate() const {
+        return this->src->text.locate(this->src->start(this->offset));
+    }
+    // source offset of the current token (see `input_t::position`).
+    size_t position() const {
+        return this->src->text.position() + this->src->start(this->offset);
+    }
+    pair<int, int> locate_position(size_t const & position) const {
+        return this->src->text.locate_position(position);
     }
 };
 
@@ -3,9 +3,57 @@
 
 #include <vector>
 #include <functional>
+#include "input_t.hpp"
+#include "charset.hpp"
 #include "patch.hpp"
+#include "profile.hpp"
 using namespace std;
 
+/**
+ * The result of applying a parser to an input stream: the number of consumed elements (negative on failure) and
+ * the parsed value. It carries no description, so the success path does no string work at all; the expected
+ * text of a failure is asked from the parser (`name()`) only when the failure is reported (see `ParsecT`).
+ */
+template<typename T>
+using result_t = pair<int, T>;
+
+// The length of a failure past a cut point (see `commit`), as opposed to -1 for a failure that may be retried
+// with other alternatives.
+constexpr int committed_failure = -2;
+
+/**
+ * FIRST set of a parser: the characters a match may start with, and whether it may match the empty string.
+ * Parsers that can tell (leaf parsers and combinators built from them) provide a `first()` method, `first_of`
+ * falls back to "anything, possibly empty" for the other ones (e.g. functions behind `parser_t`).
+ */
+struct first_t {
+    charset_t cs;
+    bool nullable;
+    // FIRST of `a` followed by `b`.
+    static first_t seq(first_t const & a, first_t const & b) {
+        return a.nullable ? first_t{a.cs | b.cs, b.nullable} : a;
+    }
+    // FIRST of `a` or `b`.
+    static first_t alt(first_t const & a, first_t const & b) {
+        return first_t{a.cs | b.cs, a.nullable || b.nullable};
+    }
+    static first_t unknown() {
+        return first_t{~charset_t(), true};
+    }
+};
+template<typename P>
+auto first_of_helper(P const & p, int) -> decltype(p.first()) {
+    return p.first();
+}
+template<typename P>
+first_t first_of_helper(P const &, long) {
+    return first_t::unknown();
+}
+template<typename P>
+first_t first_of(P const & p) {
+    return first_of_helper(p, 0);
+}
+
 // data type: Maybe
 template<typename T>
 struct Maybe{
@@ -45,6 +93,7 @@ struct ValueT {
     V const actual;
     string expected;
     bool strict;
+    vector<diagnostic_t> diagnostics; // errors recovered from, a parse with diagnostics isn't a success.
 
     string str(int n) const { return to_string(n); }
     string str(char c) const { return string(1, c); }
@@ -78,8 +127,21 @@ struct ParseError: public exception {
 };
 
 
+// The stream type a parser runs on: `input_type` of the parser if it declares one (e.g. a `parser_t` over
+// tokens), characters otherwise.
+template<typename P>
+auto input_type_helper(P const *, int) -> typename P::input_type;
+template<typename P>
+input_t input_type_helper(P const *, long);
+template<typename P>
+struct input_type_of {
+    using type = decltype(input_type_helper<P>(nullptr, 0));
+};
+
 /**
- * Parser model, wraps a function parse a Value object from a stream at specified position.
+ * Parser model, wraps a function parse a Value object from a stream at specified position. The source text is
+ * converted to the stream type of the parser first (e.g. split into tokens), the reported length is counted in
+ * characters of the source whatever the stream type.
  */
 template<typename P, typename = typename P::parser_type>
 struct ParsecT {
@@ -87,50 +149,155 @@ private:
     P const parser;
 public:
     using V = typename P::parser_type;
+    using I = typename input_type_of<P>::type;
     constexpr ParsecT(P const & parser): parser(parser) {}
     string name() const { return "ParsecT"; }
-    ValueT<V> parse(input_t *text) const {
+    ValueT<V> parse(input_t const & source) const {
         pair<int, int> loc = make_pair(1, 1);
-        tuple<int, V, string> res;
+        result_t<V> res = make_pair(-1, V());
+        string expected;
+        size_t reported = source.diagnostics().size();
+        I text(source);
         try { // try exception throwed during operating the stream object.
             res = parser(text);
         } catch (std::exception & e) {
             cout << string("!!!Exception: ") + string(e.what()) << endl;
-            res = make_tuple(-1, V(), "!!!Exception: " + string(e.what()));
+            expected = "!!!Exception: " + string(e.what());
         } catch (...) {
             cout << string("!!!Exception: ") + "unknown exception." << endl;
         }
-        text = text->next(std::get<0>(res)); // move ahead offset.
-        if (!text->empty()) {
+        I rest = text.next(std::get<0>(res)); // move ahead offset.
+        if (!rest.empty()) {
             // cout << "NOT COMSUME ALL TOKEN IN THE INPUT STREAM!" << endl;
-            // cout << "    in stream: " << (*text) << endl;
+            // cout << "    in stream: " << rest << endl;
+        }
+        if (std::get<0>(res) < 0 && expected.empty()) { // build the error text only for a reported failure.
+            expected = parser.name();
         }
-        return ValueT<V>(std::get<0>(res) != -1, loc, std::get<0>(res), std::get<1>(res), std::get<2>(res), text->empty());
+        vector<diagnostic_t> diagnostics(source.diagnostics().begin() + reported, source.diagnostics().end());
+        ValueT<V> ans(std::get<0>(res) >= 0 && diagnostics.empty(), loc, std::get<0>(res) < 0 ? -1 : text.width(std::get<0>(res)), std::get<1>(res), expected, rest.empty());
+        ans.diagnostics = diagnostics;
+        return ans;
     }
-    ValueT<V> operator () (input_t *text) const {
+    ValueT<V> parse(input_t const *text) const {
+        return this->parse(*text);
+    }
+    ValueT<V> operator () (input_t const & text) const {
         return this->parse(text);
     }
+    ValueT<V> operator () (input_t const *text) const {
+        return this->parse(*text);
+    }
 };
 
-template<typename T>
-class parser_t {
+/**
+ * Parser over a plain function `pair<int, T>(I const &)`. The function is a template argument, so the call is
+ * resolved at compile time and can be inlined into the combinators built on top of the parser. `parser_fn` is
+ * the common case of a function over characters.
+ */
+template<typename T, typename I, pair<int, T> (*fn)(I const &)>
+class basic_parser_fn {
+private:
+    char const *desc;
+public:
+    using parser_type = T;
+    using input_type = I;
+    constexpr basic_parser_fn(char const *desc): desc(desc) {}
+    result_t<parser_type> operator () (I const & text) const {
+#ifdef ENABLE_PROFILE
+        static profile_stat_t *stat = profiler::instance().stat(this->desc);
+        profile_scope_t scope(stat);
+        auto res = fn(text);
+        scope.finish(text.width(std::get<0>(res)));
+        return res;
+#else
+        return fn(text);
+#endif
+    }
+    string const name() const { return this->desc; }
+};
+template<typename T, pair<int, T> (*fn)(input_t const &)>
+using parser_fn = basic_parser_fn<T, input_t, fn>;
+
+/**
+ * Parser over a function with one bound argument (the character or string to match, etc), the replacement of
+ * `std::bind` that doesn't hide the function behind an indirect call.
+ */
+template<typename T, typename A, pair<int, T> (*fn)(A const &, input_t const &)>
+class parser_bind {
 private:
-    pair<int, int> loc;
     string const desc;
-    function<pair<int, T>(input_t *)> fn;
+    A const arg;
+    first_t const first_set;
+public:
+    using parser_type = T;
+    parser_bind(string const & desc, A const & arg, first_t const & first_set = first_t::unknown())
+        : desc(desc), arg(arg), first_set(first_set) {}
+    result_t<parser_type> operator () (input_t const & text) const {
+        return fn(this->arg, text);
+    }
+    string const name() const { return this->desc; }
+    first_t first() const { return this->first_set; }
+};
+
+/**
+ * Type-erased parser. Combinators keep the concrete type of the parsers they are built from, `parser_t` is
+ * the explicit boundary where that type must be forgotten: a grammar rule that refers to itself (directly or
+ * through other rules) can't spell its own type, so recursive rules are declared as `parser_t` and defined
+ * by a function. All copies of a `parser_t` share the same body, so copying one into a combinator is cheap
+ * and a function set by `setfn` is seen by every copy. `I` is the stream type the rule runs on.
+ */
+template<typename T, typename I = input_t>
+class parser_t {
+private:
+    struct body_t {
+        string const desc;
+        function<pair<int, T>(I const &)> fn;
+        size_t const uid;
+        bool const memoized; // packrat: remember the result at every offset of the input.
+#ifdef ENABLE_PROFILE
+        profile_stat_t *const stat;
+        body_t(string const & desc, function<pair<int, T>(I const &)> const & fn, bool const memoized)
+            : desc(desc), fn(fn), uid(parsec_uid()), memoized(memoized), stat(profiler::instance().stat(desc)) {}
+#else
+        body_t(string const & desc, function<pair<int, T>(I const &)> const & fn, bool const memoized)
+            : desc(desc), fn(fn), uid(parsec_uid()), memoized(memoized) {}
+#endif
+    };
+    result_t<T> apply(I const & text) const {
+        if (!this->body->memoized) {
+            return this->body->fn(text);
+        }
+        pair<int, T> const *hit = text.template recall<pair<int, T>>(this->body->uid);
+        if (hit) {
+            return *hit;
+        }
+        auto res = this->body->fn(text);
+        text.remember(this->body->uid, res);
+        return res;
+    }
+    shared_ptr<body_t> body;
 public:
     using parser_type = T;
-    parser_t(string const desc): desc(desc) {}
-    parser_t(string const desc, function<pair<int, T>(input_t *)> fn): desc(desc), fn(fn) {}
+    using input_type = I;
+    parser_t(string const desc): body(make_shared<body_t>(desc, nullptr, false)) {}
+    parser_t(string const desc, function<pair<int, T>(I const &)> fn, bool const memoized = false)
+        : body(make_shared<body_t>(desc, fn, memoized)) {}
     ~parser_t() {}
-    void setfn(function<pair<int, T>(input_t *)> const & fn) {
-        this->fn = fn;
+    void setfn(function<pair<int, T>(I const &)> const & fn) {
+        this->body->fn = fn;
     }
-    tuple<int, parser_type const, string const> operator () (input_t *text) const {
-        auto res = this->fn(text);
-        return make_tuple(res.first, res.second, this->name());
+    result_t<parser_type> operator () (I const & text) const {
+#ifdef ENABLE_PROFILE
+        profile_scope_t scope(this->body->stat);
+        auto res = this->apply(text);
+        scope.finish(text.width(std::get<0>(res)));
+        return res;
+#else
+        return this->apply(text);
+#endif
     }
-    string const name() const { return this->desc; }
+    string const name() const { return this->body->desc; }
 };
 
 
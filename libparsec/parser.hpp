@@ -5,7 +5,10 @@
 #ifndef __PARSER_HPP__
 #define __PARSER_HPP__
 
+#include <initializer_list>
+#include <vector>
 #include "input_t.hpp"
+#include "charset.hpp"
 #include "parse_tool.hpp"
 #include "patch.hpp"
 
@@ -13,12 +16,12 @@
     #define EOF (-1)
 #endif
 
-pair<int, char> any_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    // char k, c = text->at(0);
+pair<int, char> any_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    // char k, c = text.at(0);
     // bool escaped = false;
-    // if (c == '\\' && text->length() >= 2) {
-    //     switch (text->at(1)) {
+    // if (c == '\\' && text.length() >= 2) {
+    //     switch (text.at(1)) {
     //         case '\\': k = '\\'; break;
     //         case '0': k = '\0'; break;
     //         case 'n': k = '\n'; break;
@@ -27,7 +30,7 @@ pair<int, char> any_fn(input_t *text) {
     //         case 't': k = '\t'; break;
     //         case 'b': k = '\b'; break;
     //         case 'f': k = '\f'; break;
-    //         default: k = text->at(1);
+    //         default: k = text.at(1);
     //     }
     //     escaped = true;
     // }
@@ -35,101 +38,101 @@ pair<int, char> any_fn(input_t *text) {
     //     k = c;
     // }
     // return make_pair(k != EOF ? (escaped ? 2 : 1) : (-1), k);
-    char c = text->at(0);
+    char c = text.at(0);
     return make_pair(c != EOF ? (1) : (-1), c);
 }
-static const class parser_t<char> any("any character", any_fn);
+static const parser_fn<char, any_fn> any("any character");
 
-pair<int, char> blank_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isblank(c) ? (1) : (-1), c);
+pair<int, char> blank_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(blank_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> blank("blank", blank_fn);
+static const parser_fn<char, blank_fn> blank("blank");
 
-pair<int, char> cntrl_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::iscntrl(c) ? (1) : (-1), c);
+pair<int, char> cntrl_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(cntrl_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> cntrl("cntrl", cntrl_fn);
+static const parser_fn<char, cntrl_fn> cntrl("cntrl");
 
-pair<int, char> space_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isspace(c) ? (1) : (-1), c);
+pair<int, char> space_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(space_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> space("space", space_fn);
+static const parser_fn<char, space_fn> space("space");
 
-pair<int, char> end_f_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
+pair<int, char> end_f_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
     return make_pair(c == EOF ? (1) : (-1), c);
 }
-static const class parser_t<char> end_f("eof", end_f_fn);
+static const parser_fn<char, end_f_fn> end_f("eof");
 
-pair<int, char> eol_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
+pair<int, char> eol_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
     return make_pair(c == '\n' ? (1) : (-1), c);
 }
-static const class parser_t<char> eol("eol", eol_fn);
+static const parser_fn<char, eol_fn> eol("eol");
 
-pair<int, char> tab_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
+pair<int, char> tab_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
     return make_pair(c == '\t' ? (1) : (-1), c);
 }
-static const class parser_t<char> tab("tab", tab_fn);
+static const parser_fn<char, tab_fn> tab("tab");
 
-pair<int, char> digit_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isdigit(c) ? (1) : (-1), c);
+pair<int, char> digit_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(digit_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> digit("digit", digit_fn);
+static const parser_fn<char, digit_fn> digit("digit");
 
-pair<int, char> xdigit_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isxdigit(c) ? (1) : (-1), c);
+pair<int, char> xdigit_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(xdigit_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> xdigit("xdigit", xdigit_fn);
+static const parser_fn<char, xdigit_fn> xdigit("xdigit");
 
-pair<int, char> upper_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isupper(c) ? (1) : (-1), c);
+pair<int, char> upper_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(upper_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> upper("upper", upper_fn);
+static const parser_fn<char, upper_fn> upper("upper");
 
-pair<int, char> lower_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::islower(c) ? (1) : (-1), c);
+pair<int, char> lower_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(lower_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> lower("lower", lower_fn);
+static const parser_fn<char, lower_fn> lower("lower");
 
-pair<int, char> alpha_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isalpha(c) ? (1) : (-1), c);
+pair<int, char> alpha_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(alpha_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> alpha("alpha", alpha_fn);
+static const parser_fn<char, alpha_fn> alpha("alpha");
 
-pair<int, char> alnum_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isalnum(c) ? (1) : (-1), c);
+pair<int, char> alnum_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(alnum_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> alnum("alnum", alnum_fn);
+static const parser_fn<char, alnum_fn> alnum("alnum");
 
-pair<int, char> print_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    // char k, h, c = text->at(0);
+pair<int, char> print_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    // char k, h, c = text.at(0);
     // bool escaped = false;
-    // if (c == '\\' && text->length() >= 2) {
-    //     switch (text->at(1)) {
+    // if (c == '\\' && text.length() >= 2) {
+    //     switch (text.at(1)) {
     //         case '\\': k = '\\'; break;
     //         case '0': k = '\0'; break;
     //         case 'n': k = '\n'; break;
@@ -138,67 +141,204 @@ pair<int, char> print_fn(input_t *text) {
     //         case 't': k = '\t'; break;
     //         case 'b': k = '\b'; break;
     //         case 'f': k = '\f'; break;
-    //         default: k = text->at(1);
+    //         default: k = text.at(1);
     //     }
-    //     h = text->at(1); escaped = true;
+    //     h = text.at(1); escaped = true;
     // }
     // else {
     //     h = c; k = c;
     // }
     // cout << ";; " << (int)k << endl;
     // return make_pair(::isprint(h) ? (escaped ? 2 : 1) : (-1), k);
-    char c = text->at(0);
-    return make_pair(::isprint(c) ? (1) : (-1), c);
+    char c = text.at(0);
+    return make_pair(print_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> print("print", print_fn);
+static const parser_fn<char, print_fn> print("print");
 
-pair<int, char> graph_fn(input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(::isgraph(c) ? (1) : (-1), c);
+pair<int, char> graph_fn(input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
+    return make_pair(graph_set.test(c) ? (1) : (-1), c);
 }
-static const class parser_t<char> graph("graph", graph_fn);
+static const parser_fn<char, graph_fn> graph("graph");
 
 
-pair<int, char> character_helper(char const & ch, input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
+pair<int, char> character_helper(char const & ch, input_t const & text) {
+    if (text.empty()) { return make_pair(-1, '\0'); }
+    char c = text.at(0);
     return make_pair(ch == c ? (1) : (-1), ch);
 }
-parser_t<char> character(char const & ch) {
-    auto fn = std::bind(character_helper, ch, std::placeholders::_1);
-    return parser_t<char>("character: " + string(1, ch), fn);
+using character_parser = parser_bind<char, char, character_helper>;
+character_parser character(char const & ch) {
+    return character_parser("character: " + string(1, ch), ch, first_t{charset_t::range(ch, ch), false});
 }
 
-pair<int, string> string_literal_helper(const string & str, input_t *text) {
-    if (text->empty()) { return make_pair(-1, "\0"); }
-    string s = text->take(str.length());
+pair<int, string> string_literal_helper(const string & str, input_t const & text) {
+    if (text.empty()) { return make_pair(-1, "\0"); }
+    slice_t s = text.take(str.length());
     return make_pair(str == s ? str.length() : (-1), str);
 }
-parser_t<string> string_literal(string const & str) {
-    auto fn = std::bind(string_literal_helper, str, std::placeholders::_1);
-    return parser_t<string>("string literal: " + str, fn);
+using string_literal_parser = parser_bind<string, string, string_literal_helper>;
+string_literal_parser string_literal(string const & str) {
+    return string_literal_parser("string literal: " + str, str,
+        str.empty() ? first_t{charset_t(), true} : first_t{charset_t::range(str[0], str[0]), false});
 }
 
-pair<int, char> one_of_helper(string const & options, input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(options.find(c) != options.npos ? (1) : (-1), c);
+// Parser matching one of a set of literal strings in a single pass, with longest-match semantics (so `<`
+// doesn't shadow `<=` whatever the order of the words). The words are stored in a trie that's built once,
+// when the parser is constructed; the result is the matched word.
+class keywords_parser {
+private:
+    struct node_t {
+        char c;
+        int child, sibling; // first child and next sibling, -1 if none.
+        int word; // index of the word ending at this node, -1 if none.
+    };
+    vector<node_t> nodes; // nodes[0] is the root.
+    vector<string> words;
+    string desc;
+    first_t first_set;
+
+    int step(int n, char c) const {
+        for (int k = this->nodes[n].child; k != -1; k = this->nodes[k].sibling) {
+            if (this->nodes[k].c == c) { return k; }
+        }
+        return -1;
+    }
+public:
+    using parser_type = string;
+    keywords_parser(initializer_list<string> const & words)
+        : nodes(1, node_t{'\0', -1, -1, -1}), words(words), first_set{charset_t(), false} {
+        for (size_t i = 0; i < this->words.size(); ++i) {
+            this->first_set = first_t::alt(this->first_set, this->words[i].empty()
+                ? first_t{charset_t(), true} : first_t{charset_t::range(this->words[i][0], this->words[i][0]), false});
+            int n = 0;
+            for (char c: this->words[i]) {
+                int k = this->step(n, c);
+                if (k == -1) {
+                    k = (int)this->nodes.size();
+                    this->nodes.emplace_back(node_t{c, -1, this->nodes[n].child, -1});
+                    this->nodes[n].child = k;
+                }
+                n = k;
+            }
+            this->nodes[n].word = (int)i;
+            this->desc += (i == 0 ? "keywords: " : " | ") + this->words[i];
+        }
+    }
+    // index of the longest word that is a prefix of `s[0, n)` (and its length in `len`), -1 if none.
+    int longest(char const *s, size_t n, int & len) const {
+        int ans = -1, k = 0;
+        for (size_t i = 0; i < n && (k = this->step(k, s[i])) != -1; ++i) {
+            if (this->nodes[k].word != -1) {
+                ans = this->nodes[k].word;
+                len = (int)i + 1;
+            }
+        }
+        return ans;
+    }
+    // index of the word equal to `s[0, n)`, -1 if none.
+    int find(char const *s, size_t n) const {
+        int k = 0;
+        for (size_t i = 0; i < n && k != -1; ++i) {
+            k = this->step(k, s[i]);
+        }
+        return k == -1 ? -1 : this->nodes[k].word;
+    }
+    result_t<parser_type> operator () (input_t const & text) const {
+        slice_t rest = text.take(text.length());
+        int len = -1, w = this->longest(rest.ptr, rest.len, len);
+        return w == -1 ? make_pair(-1, string()) : make_pair(len, this->words[w]);
+    }
+    string const name() const { return this->desc; }
+    first_t first() const { return this->first_set; }
+};
+keywords_parser keywords(initializer_list<string> const & words) {
+    return keywords_parser(words);
+}
+
+// Parser matching one character of a character class, a single table lookup per character.
+class charset_parser {
+private:
+    string const desc;
+    charset_t const cs;
+public:
+    using parser_type = char;
+    charset_parser(string const & desc, charset_t const & cs): desc(desc), cs(cs) {}
+    result_t<parser_type> operator () (input_t const & text) const {
+        if (text.empty()) { return make_pair(-1, '\0'); }
+        char c = text.at(0);
+        return make_pair(this->cs.test(c) ? (1) : (-1), c);
+    }
+    string const name() const { return this->desc; }
+    first_t first() const { return first_t{this->cs, false}; }
+};
+
+charset_parser one_of(string const & options) {
+    return charset_parser("one of " + options, charset_t::of(options.c_str()));
+}
+charset_parser one_of(charset_t const & cs, string const & desc = "one of a character class") {
+    return charset_parser(desc, cs);
 }
-parser_t<char> one_of(string const & options) {
-    auto fn = std::bind(one_of_helper, options, std::placeholders::_1);
-    return parser_t<char>("one of " + options, fn);
+
+charset_parser no_one_of(string const & options) {
+    return charset_parser("none of " + options, ~charset_t::of(options.c_str()));
 }
 
-pair<int, char> no_one_of_helper(string const & options, input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    return make_pair(options.find(c) == options.npos ? (1) : (-1), c);
+// Parser consuming the longest run of characters of a class (at least `least` of them) in bulk, see
+// `charset_scanner`. The result is a view of the run in the input, no value is built per character.
+class span_parser {
+private:
+    string const desc;
+    charset_scanner const scanner;
+    int const least;
+public:
+    using parser_type = slice_t;
+    span_parser(string const & desc, charset_t const & cs, int const least): desc(desc), scanner(cs), least(least) {}
+    result_t<parser_type> operator () (input_t const & text) const {
+        slice_t rest = text.take(text.length());
+        int n = (int)this->scanner.span(rest.ptr, rest.len);
+        if (n < this->least) { return make_pair(-1, slice_t()); }
+        return make_pair(n, slice_t(rest.ptr, n));
+    }
+    string const name() const { return this->desc; }
+    first_t first() const { return first_t{this->scanner.charset(), this->least == 0}; }
+};
+
+// `span_while(cs)` consumes zero or more characters of class `cs`, `span_while1(cs)` one or more.
+span_parser span_while(charset_t const & cs, string const & desc = "span of a character class") {
+    return span_parser(desc, cs, 0);
 }
-parser_t<char> no_one_of(string const & options) {
-    auto fn = std::bind(no_one_of_helper, options, std::placeholders::_1);
-    return parser_t<char>("one of " + options, fn);
+span_parser span_while1(charset_t const & cs, string const & desc = "span of a character class") {
+    return span_parser(desc, cs, 1);
 }
 
+// Parser matching one token of a token stream (see `token_input_t`): a token of kind `kind`, and with the text
+// `text` unless it's empty. The result is the text of the token.
+class token_parser {
+private:
+    int const kind;
+    string const text;
+    string const desc;
+public:
+    using parser_type = slice_t;
+    token_parser(int const kind, string const & text, string const & desc): kind(kind), text(text), desc(desc) {}
+    template<typename I>
+    result_t<parser_type> operator () (I const & text) const {
+        if (text.empty()) { return make_pair(-1, slice_t()); }
+        token_t const & t = text.at(0);
+        if (t.kind != this->kind || (!this->text.empty() && t.text != this->text)) { return make_pair(-1, slice_t()); }
+        return make_pair(1, t.text);
+    }
+    string const name() const { return this->desc; }
+    first_t first() const { return this->text.empty() ? first_t::unknown() : first_t{charset_t::range(this->text[0], this->text[0]), false}; }
+};
+
+token_parser token(int const kind) {
+    return token_parser(kind, "", "token of kind " + to_string(kind));
+}
+token_parser token(int const kind, string const & text) {
+    return token_parser(kind, text, "token: " + text);
+}
 
 #endif /* __PARSER_HPP__ */
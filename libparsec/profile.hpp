@@ -0,0 +1,107 @@
+#ifndef __PROFILE_HPP__
+#define __PROFILE_HPP__
+
+/**
+ * Per-parser profiling.
+ *
+ * Enabled by building with `-DENABLE_PROFILE` (`make PROFILE=1`), and compiled out otherwise. Every named parser
+ * (`parser_t`, `basic_parser_fn` and the parsers wrapped by `profile(p, name)`) counts its invocations, successes
+ * and failures, the source characters it consumed and the time spent in it. The time of a recursive parser is the
+ * time of its outermost invocations, so it isn't counted twice; parsers with the same name share one entry. The
+ * table is printed to stderr at exit, sorted by time, or written as CSV to the file named by the environment
+ * variable `PARSEC_PROFILE_CSV`.
+ */
+
+#ifdef ENABLE_PROFILE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+struct profile_stat_t {
+    size_t calls = 0, success = 0, failure = 0;
+    long long consumed = 0; // source characters.
+    std::chrono::nanoseconds time{0};
+    int active = 0; // depth of the invocations in progress.
+};
+
+class profiler {
+private:
+    std::map<std::string, profile_stat_t> table;
+    profiler() {}
+public:
+    ~profiler() { this->dump(); }
+    static profiler & instance() {
+        static profiler p;
+        return p;
+    }
+    profile_stat_t *stat(std::string const & name) { return &this->table[name]; }
+    std::map<std::string, profile_stat_t> const & stats() const { return this->table; }
+    void dump() const {
+        std::vector<std::pair<std::string, profile_stat_t>> rows;
+        for (auto && entry: this->table) {
+            if (entry.second.calls > 0) {
+                rows.emplace_back(entry);
+            }
+        }
+        std::sort(rows.begin(), rows.end(), [](std::pair<std::string, profile_stat_t> const & a, std::pair<std::string, profile_stat_t> const & b) {
+            return a.second.time > b.second.time;
+        });
+        char const *csv = std::getenv("PARSEC_PROFILE_CSV");
+        if (csv) {
+            std::ofstream out(csv);
+            out << "parser,calls,success,failure,consumed,time_us" << std::endl;
+            for (auto && row: rows) {
+                out << '"' << row.first << "\"," << row.second.calls << "," << row.second.success << "," << row.second.failure
+                    << "," << row.second.consumed << "," << row.second.time.count() / 1000.0 << std::endl;
+            }
+            return;
+        }
+        std::cerr << std::left << std::setw(40) << "parser" << std::right << std::setw(10) << "calls" << std::setw(10) << "success"
+            << std::setw(10) << "failure" << std::setw(12) << "consumed" << std::setw(12) << "time(us)" << std::endl;
+        for (auto && row: rows) {
+            std::cerr << std::left << std::setw(40) << row.first << std::right << std::setw(10) << row.second.calls
+                << std::setw(10) << row.second.success << std::setw(10) << row.second.failure << std::setw(12) << row.second.consumed
+                << std::setw(12) << std::fixed << std::setprecision(1) << row.second.time.count() / 1000.0 << std::endl;
+        }
+    }
+};
+
+// Records one invocation of a parser, for the scope of the invocation.
+class profile_scope_t {
+private:
+    profile_stat_t *stat;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit profile_scope_t(profile_stat_t *stat): stat(stat) {
+        stat->calls = stat->calls + 1;
+        if (stat->active++ == 0) {
+            this->start = std::chrono::steady_clock::now();
+        }
+    }
+    ~profile_scope_t() {
+        if (--this->stat->active == 0) {
+            this->stat->time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start);
+        }
+    }
+    // the parser has returned, `width` source characters consumed (negative on failure).
+    void finish(int width) {
+        if (width < 0) {
+            this->stat->failure = this->stat->failure + 1;
+        }
+        else {
+            this->stat->success = this->stat->success + 1;
+            this->stat->consumed = this->stat->consumed + width;
+        }
+    }
+};
+
+#endif /* ENABLE_PROFILE */
+
+#endif /* __PROFILE_HPP__ */
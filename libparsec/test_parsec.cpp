@@ -10,7 +10,7 @@ struct spaces {
     using parser_type = string;
     constexpr spaces() {}
     string name() const { return "spaces"; }
-    tuple<int, parser_type, string> operator () (input_t *text) const {
+    result_t<parser_type> operator () (input_t const & text) const {
         function<string (vector<char>)> fn = [](vector<char> const & vec) {
             string ans; for (auto c: vec) { ans.push_back(c); } return ans;
         };
@@ -19,6 +19,59 @@ struct spaces {
     }
 } static const spaces;
 
+// Input stream.
+
+TEST(InputStream, Locate) {
+    input_t s("ab\ncd\n\nef");
+    EXPECT_EQ(s.locate(), make_pair(1, 1));
+    EXPECT_EQ(s.drop(1).locate(), make_pair(1, 2));
+    EXPECT_EQ(s.drop(3).locate(), make_pair(2, 1));
+    EXPECT_EQ(s.drop(2).drop(3).locate(), make_pair(2, 3));
+    EXPECT_EQ(s.drop(6).locate(), make_pair(3, 1));
+    EXPECT_EQ(s.drop(8).locate(), make_pair(4, 2));
+    EXPECT_EQ(s.drop(100).locate(), make_pair(4, 3));
+    EXPECT_TRUE(s.drop(100).empty());
+}
+
+// words and single punctuations, separated by spaces.
+struct word_lexer {
+    enum kind_t { WORD, PUNCT };
+    static vector<token_t> lex(input_t const & text) {
+        vector<token_t> tokens;
+        slice_t s = text.take(text.length());
+        for (size_t i = 0; i < s.len; ) {
+            size_t n = 1;
+            if (space_set.test(s.ptr[i])) { i = i + 1; continue; }
+            while (alpha_set.test(s.ptr[i]) && i + n < s.len && alpha_set.test(s.ptr[i + n])) { n = n + 1; }
+            tokens.emplace_back(token_t{alpha_set.test(s.ptr[i]) ? WORD : PUNCT, slice_t(s.ptr + i, n), i});
+            i = i + n;
+        }
+        return tokens;
+    }
+};
+
+TEST(InputStream, Tokens) {
+    token_input_t<word_lexer> s(input_t("ab (c)\n  def "));
+    EXPECT_EQ(s.length(), 5);
+    EXPECT_EQ(s.at(1).kind, word_lexer::PUNCT);
+    EXPECT_EQ(s.at(2).text, "c");
+    EXPECT_EQ(s.drop(4).locate(), make_pair(2, 3));
+    EXPECT_EQ(s.width(1), 3);
+    EXPECT_EQ(s.width(5), 13);
+    EXPECT_EQ(s.drop(1).width(3), 6);
+
+    parser_t<vector<string>, token_input_t<word_lexer>> words("words", [](token_input_t<word_lexer> const & text) {
+        auto word = token(word_lexer::WORD) / [](slice_t const & s) { return s.str(); };
+        return (word % (token(word_lexer::PUNCT, ",") ^ token(word_lexer::PUNCT, ";")))(text);
+    });
+    auto parse_tool = ParsecT<decltype(words)>(words);
+    auto res = parse_tool(new input_t(" a, bc ;d e"));
+    EXPECT_EQ(res.status, true);
+    EXPECT_EQ(res.actual, vector<string>({"a", "bc", "d"}));
+    EXPECT_EQ(res.len, 10);
+    EXPECT_EQ(res.strict, false);
+}
+
 // Primitive parsers.
 
 TEST(Primitive, AnyCharacter) {
@@ -78,6 +131,74 @@ TEST(Primitive, StringLiteral) {
     EXPECT_EQ(res2.status, false);
 }
 
+TEST(Primitive, OneOf) {
+    auto parser = one_of("xyz") + no_one_of("xyz");
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("ya"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual.first, 'y');
+    EXPECT_EQ(res1.actual.second, 'a');
+
+    auto res2 = parse_tool(new input_t("yz"));
+    EXPECT_EQ(res2.status, false);
+}
+
+TEST(Primitive, RecursiveParser) {
+    // parser_t is the type-erasure boundary for recursive rules: nested = '(' nested ')' | 'x'.
+    parser_t<int> nested("nested parentheses");
+    auto parser = ((character('(') >> nested << character(')')) / [](int depth) { return depth + 1; })
+        | (character('x') / [](char) { return 0; });
+    nested.setfn([parser](input_t const & text) {
+        auto res = parser(text);
+        return make_pair(std::get<0>(res), std::get<1>(res));
+    });
+    auto parse_tool = ParsecT<decltype(nested)>(nested);
+
+    auto res1 = parse_tool(new input_t("(((x)))"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual, 3);
+    EXPECT_EQ(res1.len, 7);
+
+    auto res2 = parse_tool(new input_t("((x)"));
+    EXPECT_EQ(res2.status, false);
+}
+
+TEST(Primitive, Keywords) {
+    auto parser = keywords({"<", "=", "<=", "<>", "do", "downto"});
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("<= x"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual, "<=");
+    EXPECT_EQ(res1.len, 2);
+
+    auto res2 = parse_tool(new input_t("< x"));
+    EXPECT_EQ(res2.actual, "<");
+    EXPECT_EQ(res2.len, 1);
+
+    EXPECT_EQ(parse_tool(new input_t("downto")).actual, "downto");
+    EXPECT_EQ(parse_tool(new input_t("down")).actual, "do");
+    EXPECT_EQ(parse_tool(new input_t(">")).status, false);
+    EXPECT_EQ(parse_tool(new input_t("")).status, false);
+
+    EXPECT_EQ(parser.find("downto", 6), 5);
+    EXPECT_EQ(parser.find("down", 4), -1);
+}
+
+TEST(Primitive, ExpectedOnFailure) {
+    auto parser = string_literal("abcde");
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("abcde"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.expected, "");
+
+    auto res2 = parse_tool(new input_t("abxde"));
+    EXPECT_EQ(res2.status, false);
+    EXPECT_EQ(res2.expected, "string literal: abcde");
+}
+
 // Parser combinators.
 
 TEST(ParserCombinators, Compose) {
@@ -111,6 +232,50 @@ TEST(ParserCombinators, Choice) {
     EXPECT_EQ(res3.status, false);
 }
 
+TEST(ParserCombinators, Commit) {
+    auto xy = character('x') >> commit(character('y'));
+    auto xz = character('x') >> character('z');
+    auto parser1 = xy | xz;
+    auto parse_tool1 = ParsecT<decltype(parser1)>(parser1);
+
+    EXPECT_EQ(parse_tool1(new input_t("xy")).actual, 'y');
+    EXPECT_EQ(parse_tool1(new input_t("xz")).status, false); // committed after 'x'.
+    EXPECT_EQ(std::get<0>(parser1(input_t("xz"))), committed_failure);
+    EXPECT_EQ(std::get<0>(parser1(input_t("zz"))), -1);
+
+    auto parser2 = xy ^ xz; // backtracks anyway.
+    auto parse_tool2 = ParsecT<decltype(parser2)>(parser2);
+    auto res = parse_tool2(new input_t("xz"));
+    EXPECT_EQ(res.status, true);
+    EXPECT_EQ(res.actual, 'z');
+
+    auto parser3 = ++xy;
+    EXPECT_EQ(std::get<0>(parser3(input_t("xyxy"))), 4);
+    EXPECT_EQ(std::get<0>(parser3(input_t("xyxz"))), committed_failure);
+    EXPECT_EQ(std::get<0>((~xy)(input_t("xz"))), committed_failure);
+}
+
+TEST(ParserCombinators, Recover) {
+    auto stmt = character('x') >> commit(character('=') >> digit);
+    auto parser = recover(stmt, character(';'), "invalid statement") % character(';');
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("x=1;x=2"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_TRUE(res1.diagnostics.empty());
+
+    auto res2 = parse_tool(new input_t("x=1;x?;x=;x=3"));
+    EXPECT_EQ(res2.status, false); // recovered, but not a success.
+    EXPECT_EQ(res2.strict, true);
+    EXPECT_EQ(res2.actual, vector<char>({'1', '\0', '\0', '3'}));
+    ASSERT_EQ(res2.diagnostics.size(), (size_t)2);
+    EXPECT_EQ(res2.diagnostics[0].loc, make_pair(1, 5));
+    EXPECT_EQ(res2.diagnostics[1].loc, make_pair(1, 8));
+    EXPECT_EQ(res2.diagnostics[1].message, "invalid statement");
+
+    EXPECT_EQ(std::get<0>(recover(stmt, character(';'))(input_t("y=1;"))), -1); // not an error yet.
+}
+
 TEST(ParserCombinators, Joint) {
     auto parser = character('x') + character('y');
     auto parse_tool = ParsecT<decltype(parser)>(parser);
@@ -288,6 +453,153 @@ TEST(RepeatCombinators, Sepby1) {
     EXPECT_EQ(res2.len, 7);
 }
 
+TEST(RepeatCombinators, ManyInto) {
+    vector<char> out = {'a'};
+    auto parser = many_into(digit, back_inserter(out));
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("123x"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual, 3);
+    EXPECT_EQ(res1.len, 3);
+    EXPECT_EQ(out, vector<char>({'a', '1', '2', '3'}));
+
+    auto res2 = parse_tool(new input_t("x"));
+    EXPECT_EQ(res2.actual, 0);
+    EXPECT_EQ(out.size(), (size_t)4);
+}
+
+TEST(RepeatCombinators, ManyChars) {
+    auto parser1 = many_chars(digit);
+    auto parse_tool1 = ParsecT<decltype(parser1)>(parser1);
+    EXPECT_EQ(parse_tool1(new input_t("2015x")).actual, "2015");
+    EXPECT_EQ(parse_tool1(new input_t("x")).actual, "");
+
+    auto parser2 = many1_chars(digit);
+    auto parse_tool2 = ParsecT<decltype(parser2)>(parser2);
+    EXPECT_EQ(parse_tool2(new input_t("7")).actual, "7");
+    EXPECT_EQ(parse_tool2(new input_t("x")).status, false);
+}
+
+TEST(RepeatCombinators, CharacterClass) {
+    constexpr charset_t sign = charset_t::of("+-");
+    static_assert(sign.test('+') && sign.test('-') && !sign.test('*'), "charset_t::of");
+    static_assert(alnum_set.test('z') && alnum_set.test('0') && !alnum_set.test('_'), "alnum_set");
+    static_assert(!(print_set - sign).test('+') && (print_set - sign).test('*'), "charset_t difference");
+    static_assert((sign | digit_set).test('7') && !(sign | digit_set).test('a'), "charset_t union");
+    static_assert((~sign).test('\xff') && !(~sign).test('-'), "charset_t complement");
+
+    auto parser = (++one_of(digit_set | charset_t::of("+-"))) / fn;
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res = parse_tool(new input_t("+12-3*4"));
+    EXPECT_EQ(res.status, true);
+    EXPECT_EQ(res.actual, "+12-3");
+}
+
+TEST(RepeatCombinators, SpanWhile) {
+    auto parser = span_while(space_set) >> (span_while1(alnum_set) + span_while(space_set)) << character(';');
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    // long enough runs to go through the vector path, and tails shorter than a vector.
+    string blank(70, ' '), ident = "abc" + string(40, 'x') + "123";
+    auto res1 = parse_tool(new input_t(blank + "\n\t" + ident + blank + ";"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual.first, ident);
+    EXPECT_EQ(res1.actual.second.length(), blank.length());
+    EXPECT_EQ(res1.len, (int)(2 * blank.length() + 3 + ident.length()));
+
+    auto res2 = parse_tool(new input_t("x;"));
+    EXPECT_EQ(res2.status, true);
+    EXPECT_EQ(res2.actual.first, "x");
+
+    auto res3 = parse_tool(new input_t(blank + ";"));
+    EXPECT_EQ(res3.status, false);
+
+    charset_scanner other(charset_t::of("acegikmoqsuwy")); // too many ranges for the vector path.
+    string odd(50, 'a');
+    EXPECT_EQ(other.span((odd + "b").data(), odd.length() + 1), odd.length());
+}
+
+// Predictive choice.
+
+TEST(DispatchCombinators, FirstSet) {
+    auto number = span_while1(digit_set);
+    auto sign = ~(character('+') | character('-'));
+    EXPECT_TRUE(first_of(sign >> number).cs.test('+'));
+    EXPECT_TRUE(first_of(sign >> number).cs.test('7'));
+    EXPECT_FALSE(first_of(sign >> number).cs.test('x'));
+    EXPECT_FALSE(first_of(sign >> number).nullable);
+    EXPECT_TRUE(first_of(++number).nullable);
+    EXPECT_TRUE(first_of(keywords({"if", "then"})).cs.test('t'));
+    EXPECT_TRUE(first_of(parser_t<char>("opaque", any_fn)).nullable); // unknown.
+}
+
+TEST(DispatchCombinators, Dispatch) {
+    int tried = 0;
+    parser_t<string> counted("counted", [&tried](input_t const & text) {
+        tried += 1;
+        auto res = span_while1(alpha_set)(text);
+        return make_pair(std::get<0>(res), std::get<1>(res).str());
+    });
+    auto parser = dispatch<string>(space_set,
+        alt({"if"}, keywords({"if"}) >> span_while(space_set) >> string_literal("cond")),
+        alt((span_while(space_set) >> span_while1(digit_set)) / [](slice_t const & s) { return s.str(); }), // derived
+        alt(alpha_set, span_while(space_set) >> counted));
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("if cond"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual, "cond");
+    EXPECT_EQ(tried, 0);
+
+    auto res2 = parse_tool(new input_t("  123"));
+    EXPECT_EQ(res2.status, true);
+    EXPECT_EQ(res2.actual, "123");
+    EXPECT_EQ(res2.len, 5);
+    EXPECT_EQ(tried, 0);
+
+    auto res3 = parse_tool(new input_t(" iffy"));
+    EXPECT_EQ(res3.status, true);
+    EXPECT_EQ(res3.actual, "iffy");
+    EXPECT_EQ(tried, 1);
+
+    auto res4 = parse_tool(new input_t("(x)"));
+    EXPECT_EQ(res4.status, false);
+    EXPECT_EQ(tried, 1);
+}
+
+// Memoization (packrat parsing).
+
+TEST(MemoCombinators, Memo) {
+    int count = 0;
+    parser_t<char> counted("counted any", [&count](input_t const & text) { count += 1; return any_fn(text); });
+    auto p = memo(counted);
+    auto parser = (p >> character('x')) | (p >> character('y')) | (p >> character('z'));
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("az"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual, 'z');
+    EXPECT_EQ(count, 1);
+
+    auto res2 = parse_tool(new input_t("aw"));
+    EXPECT_EQ(res2.status, false);
+    EXPECT_EQ(count, 2); // memo table is per input source.
+}
+
+TEST(MemoCombinators, MemoizedParser) {
+    int count = 0;
+    parser_t<char> counted("counted any", [&count](input_t const & text) { count += 1; return any_fn(text); }, true);
+    auto parser = (counted >> character('x')) | (counted >> character('y'));
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res = parse_tool(new input_t("ay"));
+    EXPECT_EQ(res.status, true);
+    EXPECT_EQ(res.len, 2);
+    EXPECT_EQ(count, 1);
+}
+
 // Chain combinator for recursive grammars.
 
 TEST(ChainCombinators, LeftRecursive) {
@@ -313,7 +625,65 @@ TEST(ChainCombinators, LeftRecursive) {
 }
 
 TEST(ChainCombinators, RightRecursive) {
-    EXPECT_TRUE(true);
+    auto number = span_while1(digit_set) / [](slice_t const & s) { int n = 0; for (size_t i = 0; i < s.len; ++i) { n = n * 10 + (s.ptr[i] - '0'); } return n; };
+    auto power = character('^') / [](char) { return function<int (int, int)>([](int a, int b) { int r = 1; while (b-- > 0) { r *= a; } return r; }); };
+    auto parser = number <= power;
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    auto res1 = parse_tool(new input_t("2^3^2"));
+    EXPECT_EQ(res1.status, true);
+    EXPECT_EQ(res1.actual, 512);
+    EXPECT_EQ(res1.strict, true);
+
+    auto res2 = parse_tool(new input_t("7^"));
+    EXPECT_EQ(res2.status, true);
+    EXPECT_EQ(res2.actual, 7);
+    EXPECT_EQ(res2.len, 1);
+}
+
+TEST(ChainCombinators, Precedence) {
+    auto number = span_while1(digit_set) / [](slice_t const & s) { int n = 0; for (size_t i = 0; i < s.len; ++i) { n = n * 10 + (s.ptr[i] - '0'); } return n; };
+    auto table = op_table_t<char>({{'+', {1, false}}, {'-', {1, false}}, {'*', {2, false}}, {'/', {2, false}}, {'^', {3, true}}});
+    auto fold = [](int a, char op, int b) {
+        switch (op) {
+            case '+': return a + b;
+            case '-': return a - b;
+            case '*': return a * b;
+            case '/': return a / b;
+            default: { int r = 1; while (b-- > 0) { r *= a; } return r; }
+        }
+    };
+    auto parser = precedence(number, one_of("+-*/^%"), table, fold);
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    EXPECT_EQ(parse_tool(new input_t("1+2*3-4")).actual, 3);
+    EXPECT_EQ(parse_tool(new input_t("8-4-2")).actual, 2);
+    EXPECT_EQ(parse_tool(new input_t("2*3^2^2/9")).actual, 18);
+    EXPECT_EQ(parse_tool(new input_t("100/10/5+1")).actual, 3);
+
+    // an operator that isn't in the table, or without a right operand, isn't consumed.
+    auto res1 = parse_tool(new input_t("1+2%3"));
+    EXPECT_EQ(res1.actual, 3);
+    EXPECT_EQ(res1.len, 3);
+    auto res2 = parse_tool(new input_t("1+2*"));
+    EXPECT_EQ(res2.actual, 3);
+    EXPECT_EQ(res2.len, 3);
+    EXPECT_EQ(parse_tool(new input_t("+1")).status, false);
 }
 
 
+
+TEST(Profile, Profile) {
+    auto parser = profile(digit++, "test profile digits");
+    auto parse_tool = ParsecT<decltype(parser)>(parser);
+
+    EXPECT_EQ(parse_tool(new input_t("123a")).len, 3);
+    EXPECT_EQ(parse_tool(new input_t("a")).status, false);
+#ifdef ENABLE_PROFILE
+    profile_stat_t const & stat = profiler::instance().stats().at("test profile digits");
+    EXPECT_EQ(stat.calls, (size_t)2);
+    EXPECT_EQ(stat.success, (size_t)1);
+    EXPECT_EQ(stat.failure, (size_t)1);
+    EXPECT_EQ(stat.consumed, 3);
+#endif
+}
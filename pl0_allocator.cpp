@@ -5,24 +5,23 @@
 #include "patch.hpp"
 using namespace std;
 
-RegisterAllocator::RegisterAllocator(pl0_env<LOC> & env, struct IOOut & out, int & dist): env(env), out(out), dist(dist) {}
+RegisterAllocator::RegisterAllocator(struct IOOut & out, int & dist, int & depth): out(out), dist(dist), depth(depth) {}
 
 /***************** Simple Register Allocator (for x86 machine) *****************/
 
-SimpleAllocator::SimpleAllocator(pl0_env<LOC> & env, struct IOOut & out, int & dist): RegisterAllocator(env, out, dist) {
+SimpleAllocator::SimpleAllocator(struct IOOut & out, int & dist, int & depth): RegisterAllocator(out, dist, depth) {
     for (auto && r: regs) {
         this->used.emplace(r, false);
     }
 }
 
-string SimpleAllocator::alloc(std::string name, bool is_ref) {
+string SimpleAllocator::alloc(Value *name, bool is_ref) {
     string res;
     if ((res = exist(name)).length() != 0) {
         return res;
     }
-    LOC loc;
     for (auto && r: regs) {
-        if (!used[r] || record[r] == name) {
+        if (!used[r] || alias(record[r], name)) {
             if (is_ref && r == "ebx") {
                 continue; // don't map ebx to a variable with reference type.
             }
@@ -41,38 +40,35 @@ string SimpleAllocator::alloc(std::string name, bool is_ref) {
     return r;
 }
 
-void SimpleAllocator::remap(std::string reg, std::string dst) {
+void SimpleAllocator::remap(std::string reg, Value *dst) {
     this->spill(reg);
     this->used[reg] = true;
     this->record[reg] = dst;
 }
 
-void SimpleAllocator::release(std::string name, bool is_reg) {
-    if (is_reg) {
-        // release register.
-        if (this->used[name]) {
-            this->used[name] = false;
-            this->record.erase(name);
-        }
+void SimpleAllocator::release(std::string reg) {
+    if (this->used[reg]) {
+        this->used[reg] = false;
+        this->record.erase(reg);
     }
-    else {
-        // release variable.
-        for (auto && p: this->record) {
-            if (p.second == name) {
-                this->used[p.first] = false;
-                this->record.erase(p.first);
-                break;
-            }
+}
+
+void SimpleAllocator::release(Value *name) {
+    for (auto && p: this->record) {
+        if (alias(p.second, name)) {
+            this->used[p.first] = false;
+            this->record.erase(p.first);
+            break;
         }
     }
 }
 
-string SimpleAllocator::load(std::string name, std::string target) {
+string SimpleAllocator::load(Value *name, std::string target) {
     std::string now = this->exist(name);
     if (now != target) {
         this->remap(target, name);
         if (now.length() == 0) {
-            if (env.find(name, true)) {
+            if (name->slot.placed()) {
                 out.emit("    mov " + target + ", dword " + this->addr(name));
             }
             else {
@@ -81,31 +77,22 @@ string SimpleAllocator::load(std::string name, std::string target) {
         }
         else {
             out.emit("    mov " + target + ", " + now);
-            this->release(now, true);
+            this->release(now);
         }
     }
     return target;
 }
 
-string SimpleAllocator::load(std::string name) {
+string SimpleAllocator::load(Value *name) {
     std::string now, target;
     if ((now = exist(name)).length() != 0) {
         return now;
     }
     else {
-        LOC loc;
-        if (env.find(name, true, loc)) {
-            if (loc.is_ref) {
-                target = this->alloc(name, true);
-            }
-            else {
-                target = this->alloc(name);
-            }
+        target = this->alloc(name, name->slot.ref);
+        if (name->slot.placed()) {
             out.emit("    mov " + target + ", dword " + this->addr(name));
         }
-        else {
-            target = this->alloc(name);
-        }
         return target;
     }
 }
@@ -113,7 +100,7 @@ string SimpleAllocator::load(std::string name) {
 void SimpleAllocator::spill(std::string reg) {
     if (this->used[reg]) {
         this->store(this->record[reg]);
-        this->release(reg, true);
+        this->release(reg);
     }
     else {
         // DO NOTHING
@@ -126,63 +113,70 @@ void SimpleAllocator::spillAll() {
     }
 }
 
-void SimpleAllocator::store(std::string name) {
-    LOC loc;
-    if (this->exist(name).length() == 0) { return; }
-    // alloc space on runtime stack.
-    if (this->env.find(name, true, loc) == false) {
+void SimpleAllocator::store(Value *name) {
+    std::string reg = this->exist(name);
+    if (reg.length() == 0) { return; }
+    if (!name->slot.placed()) {
+        // temporary implicit variable: alloc space on runtime stack.
         this->dist = this->dist - 4;
-        env.push(LOC(name, dist));
-        out.emit(string("    sub esp, 4\t\t;; store temporary variable ") + name + " on runtime stack.");
+        name->slot = pl0_slot_t(this->depth, this->dist);
+        out.emit(string("    sub esp, 4\t\t;; store temporary variable ") + name->str() + " on runtime stack.");
+        out.emit(string("    mov dword [esp], ") + reg);
     }
-    // store value from register to memory.
-    for (auto && p: this->record) {
-        if (p.second == name) {
-            if (loc.name.length() == 0) {
-                // temporary implicit variable.
-                out.emit(string("    mov dword [esp], ") + p.first);
-            }
-            else {
-                // non-temporary explicit variable.
-                out.emit(string("    mov dword ") + this->addr(loc.name) + ", " + p.first);
-            }
-            this->release(p.first, true); break;
-        }
+    else {
+        // store value from register to memory.
+        out.emit(string("    mov dword ") + this->addr(name) + ", " + reg);
     }
+    this->release(reg);
 }
 
-std::string SimpleAllocator::locate(std::string name) {
+std::string SimpleAllocator::locate(Value *name) {
     std::string res;
     if ((res = exist(name)).length() == 0) {
-        LOC loc;
-        env.find(name, true, loc);
         res = "dword " + this->addr(name);
     }
     return res;
 }
 
-std::string SimpleAllocator::addr(std::string name) {
-    int d = env.depth(name);
-    LOC loc;
-    env.find(name, true, loc);
-    if (d == env.depth()) {
-        if (loc.is_ref) {
+static std::string disp(int offset) {
+    return offset == 0 ? "" : offset < 0 ? to_string(offset) : (string("+") + to_string(offset));
+}
+
+// the base register and the displacement of the slot of a variable, loading ebx with the display of an enclosing
+// frame, or with the address of a variable passed by reference.
+std::pair<std::string, int> SimpleAllocator::base(Value *name) {
+    pl0_slot_t const & slot = name->slot;
+    if (slot.depth == this->depth) {
+        if (slot.ref) {
             this->spill("ebx");
-            out.emit("    mov ebx, dword [ebp" + loc.offset +"]");
-            return "[ebx]";
+            out.emit("    mov ebx, dword [ebp" + disp(slot.offset) + "]");
+            return std::make_pair(string("ebx"), 0);
         }
         else {
-            return "[ebp" + loc.offset + "]";
+            return std::make_pair(string("ebp"), slot.offset);
         }
     }
     else {
+        // the frame of an enclosing procedure, through its display.
         this->spill("ebx");
-        out.emit("    mov ebx, dword [ebp-" + to_string(d*4) + "]");
-        if (loc.is_ref) {
-            out.emit("    mov ebx, dword [ebx" + loc.offset + "]");
+        out.emit("    mov ebx, dword [ebp-" + to_string(slot.depth*4) + "]");
+        if (slot.ref) {
+            out.emit("    mov ebx, dword [ebx" + disp(slot.offset) + "]");
+            return std::make_pair(string("ebx"), 0);
         }
-        return "[ebx" + loc.offset + "]";
+        return std::make_pair(string("ebx"), slot.offset);
     }
 }
 
+std::string SimpleAllocator::addr(Value *name) {
+    std::pair<std::string, int> b = this->base(name);
+    return "[" + b.first + disp(b.second) + "]";
+}
+
+// the address of an element of an array, indexed by a register or an immediate.
+std::string SimpleAllocator::elem(Value *array, std::string index) {
+    std::pair<std::string, int> b = this->base(array);
+    return "[" + b.first + disp(b.second) + "+4*" + index + "]";
+}
+
 
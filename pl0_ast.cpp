@@ -6,140 +6,336 @@
 #include "input_t.hpp"
 #include "parse_tool.hpp"
 #include "pl0_ast.hpp"
+#include "pl0_lexer.hpp"
 using namespace std;
 
-pair<int, pl0_ast_program *> pl0_program_fn(input_t *);
-parser_t<pl0_ast_program *> pl0_program("pl0 program", pl0_program_fn);
-pair<int, pl0_ast_prog *> pl0_prog_fn(input_t *);
-parser_t<pl0_ast_prog *> pl0_prog("pl0 prog", pl0_prog_fn);
-
-pair<int, pl0_ast_const_stmt *> pl0_const_stmt_fn(input_t *);
-parser_t<pl0_ast_const_stmt *> pl0_const_stmt("pl0 const stmt", pl0_const_stmt_fn);
-pair<int, pl0_ast_const_define *> pl0_const_define_fn(input_t *);
-parser_t<pl0_ast_const_define *> pl0_const_define("pl0 const define", pl0_const_define_fn);
-pair<int, pl0_ast_constv *> pl0_const_fn(input_t *);
-parser_t<pl0_ast_constv *> pl0_const("pl0 const", pl0_const_fn);
-pair<int, pl0_ast_constv *> pl0_char_fn(input_t *);
-parser_t<pl0_ast_constv *> pl0_char("pl0 char", pl0_char_fn);
-pair<int, pl0_ast_charseq *> pl0_charseq_fn(input_t *);
-parser_t<pl0_ast_charseq *> pl0_charseq("pl0 charseq", pl0_charseq_fn);
-pair<int, pl0_ast_constv *> pl0_unsigned_fn(input_t *);
-parser_t<pl0_ast_constv *> pl0_unsigned("pl0 unsigned", pl0_unsigned_fn);
-
-pair<int, pl0_ast_identify *> pl0_identify_fn(input_t *);
-parser_t<pl0_ast_identify *> pl0_identify("pl0 identify", pl0_identify_fn);
-pair<int, pl0_ast_var_stmt *> pl0_var_stmt_fn(input_t *);
-parser_t<pl0_ast_var_stmt *> pl0_var_stmt("pl0 vardesc stmt", pl0_var_stmt_fn);
-pair<int, pl0_ast_var_define *> pl0_var_define_fn(input_t *);
-parser_t<pl0_ast_var_define *> pl0_var_define("pl0 vardesc", pl0_var_define_fn);
-
-pair<int, pl0_ast_type *> pl0_type_fn(input_t *);
-parser_t<pl0_ast_type *> pl0_type("pl0 type", pl0_type_fn);
-pair<int, pl0_ast_primitive_type *> pl0_primitive_type_fn(input_t *);
-parser_t<pl0_ast_primitive_type *> pl0_primitive_type("pl0 primitive type", pl0_primitive_type_fn);
-
-pair<int, pl0_ast_executable *> pl0_executable_fn(input_t *);
-parser_t<pl0_ast_executable *> pl0_executable("pl0 executable, function and procedure", pl0_executable_fn);
-pair<int, pl0_ast_procedure_stmt *> pl0_procedure_stmt_fn(input_t *);
-parser_t<pl0_ast_procedure_stmt *> pl0_procedure_stmt("pl0 procedure stmt", pl0_procedure_stmt_fn);
-pair<int, pl0_ast_function_stmt *> pl0_function_stmt_fn(input_t *);
-parser_t<pl0_ast_function_stmt *> pl0_function_stmt("pl0 function stmt", pl0_function_stmt_fn);
-pair<int, pl0_ast_procedure_header *> pl0_procedure_header_fn(input_t *);
-parser_t<pl0_ast_procedure_header *> pl0_procedure_header("pl0 procedure header", pl0_procedure_header_fn);
-pair<int, pl0_ast_function_header *> pl0_function_header_fn(input_t *);
-parser_t<pl0_ast_function_header *> pl0_function_header("pl0 function header", pl0_function_header_fn);
-
-pair<int, pl0_ast_param_list *> pl0_param_list_fn(input_t *);
-parser_t<pl0_ast_param_list *> pl0_param_list("pl0 param list", pl0_param_list_fn);
-pair<int, pl0_ast_param_group *> pl0_param_group_fn(input_t *);
-parser_t<pl0_ast_param_group *> pl0_param_group("pl0 param group", pl0_param_group_fn);
-
-pair<int, pl0_ast_stmt *> pl0_stmt_fn(input_t *);
-parser_t<pl0_ast_stmt *> pl0_stmt("pl0 stmt", pl0_stmt_fn);
-pair<int, pl0_ast_null_stmt *> pl0_null_stmt_fn(input_t *);
-parser_t<pl0_ast_null_stmt *> pl0_null_stmt("pl0 null stmt", pl0_null_stmt_fn); // empty statement, not in grammar.
-pair<int, pl0_ast_assign_stmt *> pl0_assign_stmt_fn(input_t *);
-parser_t<pl0_ast_assign_stmt *> pl0_assign_stmt("pl0 assign stmt", pl0_assign_stmt_fn);
-
-pair<int, pl0_ast_function_id *> pl0_function_id_fn(input_t *);
-parser_t<pl0_ast_function_id *> pl0_function_id("pl0 function id", pl0_function_id_fn);
-pair<int, pl0_ast_expression *> pl0_expression_fn(input_t *);
-parser_t<pl0_ast_expression *> pl0_expression("pl0 expression", pl0_expression_fn);
-pair<int, pl0_ast_term *> pl0_term_fn(input_t *);
-parser_t<pl0_ast_term *> pl0_term("pl0 term", pl0_term_fn);
-pair<int, pl0_ast_factor *> pl0_factor_fn(input_t *);
-parser_t<pl0_ast_factor *> pl0_factor("pl0 factor", pl0_factor_fn);
-pair<int, pl0_ast_call_func *> pl0_call_func_fn(input_t *);
-parser_t<pl0_ast_call_func *> pl0_call_func("pl0 call func", pl0_call_func_fn);
-pair<int, pl0_ast_arg_list *> pl0_arg_list_fn(input_t *);
-parser_t<pl0_ast_arg_list *> pl0_arg_list("pl0 arg list", pl0_arg_list_fn);
-pair<int, pl0_ast_arg *> pl0_arg_fn(input_t *);
-parser_t<pl0_ast_arg *> pl0_arg("pl0 arg", pl0_arg_fn);
-
-pair<int, pl0_ast_addop *> pl0_addop_fn(input_t *);
-parser_t<pl0_ast_addop *> pl0_addop("pl0 addop", pl0_addop_fn);
-pair<int, pl0_ast_multop *> pl0_multop_fn(input_t *);
-parser_t<pl0_ast_multop *> pl0_multop("pl0 multop", pl0_multop_fn);
-
-pair<int, pl0_ast_condtion *> pl0_condition_fn(input_t *);
-parser_t<pl0_ast_condtion *> pl0_condition("pl0 condition", pl0_condition_fn);
-pair<int, pl0_ast_comp_op *> pl0_comp_op_fn(input_t *);
-parser_t<pl0_ast_comp_op *> pl0_comp_op("pl0 comp op", pl0_comp_op_fn);
-
-pair<int, pl0_ast_cond_stmt *> pl0_cond_stmt_fn(input_t *);
-parser_t<pl0_ast_cond_stmt *> pl0_cond_stmt("pl0 cond stmt", pl0_cond_stmt_fn);
-pair<int, pl0_ast_case_stmt *> pl0_case_stmt_fn(input_t *);
-parser_t<pl0_ast_case_stmt *> pl0_case_stmt("pl0 case stmt", pl0_case_stmt_fn);
-pair<int, pl0_ast_case_term *> pl0_case_term_fn(input_t *);
-parser_t<pl0_ast_case_term *> pl0_case_term("pl0 case term", pl0_case_term_fn);
-pair<int, pl0_ast_for_stmt *> pl0_for_stmt_fn(input_t *);
-parser_t<pl0_ast_for_stmt *> pl0_for_stmt("pl0 for stmt", pl0_for_stmt_fn);
-pair<int, pl0_ast_call_proc *> pl0_call_proc_fn(input_t *);
-parser_t<pl0_ast_call_proc *> pl0_call_proc("pl0 call proc", pl0_call_proc_fn);
-pair<int, pl0_ast_compound_stmt *> pl0_compound_stmt_fn(input_t *);
-parser_t<pl0_ast_compound_stmt *> pl0_compound_stmt("pl0 compound stmt", pl0_compound_stmt_fn);
-pair<int, pl0_ast_read_stmt *> pl0_read_stmt_fn(input_t *);
-parser_t<pl0_ast_read_stmt *> pl0_read_stmt("pl0 read stmt", pl0_read_stmt_fn);
-pair<int, pl0_ast_write_stmt *> pl0_write_stmt_fn(input_t *);
-parser_t<pl0_ast_write_stmt *> pl0_write_stmt("pl0 write stmt", pl0_write_stmt_fn);
-
-pair<int, pl0_ast_alnum *> pl0_alpha_fn(input_t *);
+pair<int, pl0_ast_program *> pl0_program_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_program *> pl0_program("pl0 program", pl0_program_fn);
+pair<int, pl0_ast_prog *> pl0_prog_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_prog *> pl0_prog("pl0 prog", pl0_prog_fn);
+
+pair<int, pl0_ast_const_stmt *> pl0_const_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_const_stmt *> pl0_const_stmt("pl0 const stmt", pl0_const_stmt_fn);
+pair<int, pl0_ast_const_define *> pl0_const_define_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_const_define *> pl0_const_define("pl0 const define", pl0_const_define_fn);
+pair<int, pl0_ast_constv *> pl0_const_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_constv *> pl0_const("pl0 const", pl0_const_fn);
+pair<int, pl0_ast_constv *> pl0_char_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_constv *> pl0_char("pl0 char", pl0_char_fn);
+pair<int, pl0_ast_charseq *> pl0_charseq_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_charseq *> pl0_charseq("pl0 charseq", pl0_charseq_fn, true); // memoized
+pair<int, pl0_ast_constv *> pl0_unsigned_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_constv *> pl0_unsigned("pl0 unsigned", pl0_unsigned_fn, true); // memoized
+
+pair<int, pl0_ast_identify *> pl0_identify_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_identify *> pl0_identify("pl0 identify", pl0_identify_fn, true); // memoized
+pair<int, pl0_ast_var_stmt *> pl0_var_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_var_stmt *> pl0_var_stmt("pl0 vardesc stmt", pl0_var_stmt_fn);
+pair<int, pl0_ast_var_define *> pl0_var_define_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_var_define *> pl0_var_define("pl0 vardesc", pl0_var_define_fn);
+
+pair<int, pl0_ast_type *> pl0_type_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_type *> pl0_type("pl0 type", pl0_type_fn);
+pair<int, pl0_ast_primitive_type *> pl0_primitive_type_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_primitive_type *> pl0_primitive_type("pl0 primitive type", pl0_primitive_type_fn);
+
+pair<int, pl0_ast_executable *> pl0_executable_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_executable *> pl0_executable("pl0 executable, function and procedure", pl0_executable_fn);
+pair<int, pl0_ast_procedure_stmt *> pl0_procedure_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_procedure_stmt *> pl0_procedure_stmt("pl0 procedure stmt", pl0_procedure_stmt_fn);
+pair<int, pl0_ast_function_stmt *> pl0_function_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_function_stmt *> pl0_function_stmt("pl0 function stmt", pl0_function_stmt_fn);
+pair<int, pl0_ast_procedure_header *> pl0_procedure_header_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_procedure_header *> pl0_procedure_header("pl0 procedure header", pl0_procedure_header_fn);
+pair<int, pl0_ast_function_header *> pl0_function_header_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_function_header *> pl0_function_header("pl0 function header", pl0_function_header_fn);
+
+pair<int, pl0_ast_param_list *> pl0_param_list_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_param_list *> pl0_param_list("pl0 param list", pl0_param_list_fn);
+pair<int, pl0_ast_param_group *> pl0_param_group_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_param_group *> pl0_param_group("pl0 param group", pl0_param_group_fn);
+
+pair<int, pl0_ast_stmt *> pl0_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_stmt *> pl0_stmt("pl0 stmt", pl0_stmt_fn);
+pair<int, pl0_ast_null_stmt *> pl0_null_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_null_stmt *> pl0_null_stmt("pl0 null stmt", pl0_null_stmt_fn); // empty statement, not in grammar.
+pair<int, pl0_ast_assign_stmt *> pl0_assign_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_assign_stmt *> pl0_assign_stmt("pl0 assign stmt", pl0_assign_stmt_fn);
+
+pair<int, pl0_ast_function_id *> pl0_function_id_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_function_id *> pl0_function_id("pl0 function id", pl0_function_id_fn);
+pair<int, pl0_ast_expression *> pl0_expression_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_expression *> pl0_expression("pl0 expression", pl0_expression_fn, true); // memoized
+pair<int, pl0_ast_term *> pl0_term_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_term *> pl0_term("pl0 term", pl0_term_fn, true); // memoized
+pair<int, pl0_ast_factor *> pl0_factor_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_factor *> pl0_factor("pl0 factor", pl0_factor_fn, true); // memoized
+pair<int, pl0_ast_call_func *> pl0_call_func_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_call_func *> pl0_call_func("pl0 call func", pl0_call_func_fn, true); // memoized
+pair<int, pl0_ast_arg_list *> pl0_arg_list_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_arg_list *> pl0_arg_list("pl0 arg list", pl0_arg_list_fn, true); // memoized
+pair<int, pl0_ast_arg *> pl0_arg_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_arg *> pl0_arg("pl0 arg", pl0_arg_fn);
+
+pair<int, pl0_ast_addop *> pl0_addop_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_addop *> pl0_addop("pl0 addop", pl0_addop_fn);
+pair<int, pl0_ast_multop *> pl0_multop_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_multop *> pl0_multop("pl0 multop", pl0_multop_fn);
+
+pair<int, pl0_ast_condtion *> pl0_condition_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_condtion *> pl0_condition("pl0 condition", pl0_condition_fn, true); // memoized
+pair<int, pl0_ast_comp_op *> pl0_comp_op_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_comp_op *> pl0_comp_op("pl0 comp op", pl0_comp_op_fn);
+
+pair<int, pl0_ast_cond_stmt *> pl0_cond_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_cond_stmt *> pl0_cond_stmt("pl0 cond stmt", pl0_cond_stmt_fn);
+pair<int, pl0_ast_case_stmt *> pl0_case_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_case_stmt *> pl0_case_stmt("pl0 case stmt", pl0_case_stmt_fn);
+pair<int, pl0_ast_case_term *> pl0_case_term_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_case_term *> pl0_case_term("pl0 case term", pl0_case_term_fn);
+pair<int, pl0_ast_for_stmt *> pl0_for_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_for_stmt *> pl0_for_stmt("pl0 for stmt", pl0_for_stmt_fn);
+pair<int, pl0_ast_call_proc *> pl0_call_proc_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_call_proc *> pl0_call_proc("pl0 call proc", pl0_call_proc_fn);
+pair<int, pl0_ast_compound_stmt *> pl0_compound_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_compound_stmt *> pl0_compound_stmt("pl0 compound stmt", pl0_compound_stmt_fn);
+pair<int, pl0_ast_read_stmt *> pl0_read_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_read_stmt *> pl0_read_stmt("pl0 read stmt", pl0_read_stmt_fn);
+pair<int, pl0_ast_write_stmt *> pl0_write_stmt_fn(pl0_input_t const &);
+pl0_parser_t<pl0_ast_write_stmt *> pl0_write_stmt("pl0 write stmt", pl0_write_stmt_fn);
+
+pair<int, pl0_ast_alnum *> pl0_alpha_fn(input_t const &);
 parser_t<pl0_ast_alnum *> pl0_alpha("pl0 alpha", pl0_alpha_fn);
-pair<int, pl0_ast_alnum *> pl0_digit_fn(input_t *);
+pair<int, pl0_ast_alnum *> pl0_digit_fn(input_t const &);
 parser_t<pl0_ast_alnum *> pl0_digit("pl0 digit", pl0_digit_fn);
 
+/* Source locations. */
+
+static input_t pl0_source_text("");
+
+void pl0_source(input_t const & text) {
+    pl0_source_text = text;
+}
+
+pair<int, int> pl0_locate(pl0_loc_t loc) {
+    return pl0_source_text.locate_position(loc);
+}
+
+/* Symbols. */
+
+pl0_symbol_table pl0_symbols;
+
+pl0_sym_t pl0_symbol_table::intern(std::string const & name) {
+    auto iter = this->index.find(name);
+    if (iter != this->index.end()) {
+        return pl0_sym_t(iter->second);
+    }
+    uint32_t id = (uint32_t)this->names.size();
+    this->names.emplace_back(name);
+    this->index.emplace(name, id);
+    return pl0_sym_t(id);
+}
+
+pl0_sym_t pl0_symbol_table::suffix(pl0_sym_t const & sym) {
+    std::string const & name = this->name(sym);
+    size_t p = name.rfind('_');
+    return p == name.npos ? sym : this->intern(name.substr(p + 1));
+}
+
+/* Data types. */
+
+std::string const & pl0_type_t::str() const {
+    static std::string const names[2][2][3] = {
+        {{"", "integer", "char"}, {"array", "integerarray", "chararray"}},
+        {{"ref_", "ref_integer", "ref_char"}, {"ref_array", "ref_integerarray", "ref_chararray"}},
+    };
+    return names[this->ref][this->len != -1][this->kind];
+}
+
+/* AST arena. */
+
+pl0_ast_arena pl0_arena;
+
+void *pl0_ast_arena::allocate(size_t size) {
+    size_t const align = alignof(std::max_align_t);
+    size = (size + align - 1) / align * align;
+    if (size > block_size / 4) { // a large node gets a block of its own.
+        this->blocks.emplace_back(new char[size]);
+        this->bytes += size;
+        return this->blocks.back();
+    }
+    if (this->top == nullptr || this->top + size > this->limit) {
+        this->blocks.emplace_back(new char[block_size]);
+        this->top = this->blocks.back();
+        this->limit = this->top + block_size;
+    }
+    void *p = this->top;
+    this->top += size;
+    this->bytes += size;
+    return p;
+}
+
+void pl0_ast_arena::release() {
+    for (auto iter = this->finalizers.rbegin(); iter != this->finalizers.rend(); ++iter) {
+        iter->second(iter->first);
+    }
+    for (char *block: this->blocks) {
+        delete [] block;
+    }
+    this->finalizers.clear();
+    this->blocks.clear();
+    this->top = this->limit = nullptr;
+    this->bytes = 0;
+}
+
 /* IR builder. */
 
 std::string const Value::str() const {
     switch (t) {
-        case IMM: return to_string(iv);
-        case STR: return sv;
+        case IMM: case LABEL: return to_string(iv);
+        case STR: return sv.str();
+        case TEMP: return "~t" + to_string(iv);
+        case ELEM: return "~t" + to_string(iv) + "#" + base->str() + "#" + idx->str() + "#";
+        case TEXT: return *text;
+        case MARK: {
+            static char const * const marks[] = { "allsuffix", "~write_e", "^^^^^" };
+            return marks[iv];
+        }
         default: return "";
     }
 }
 
+/* Operands. */
+
+pl0_value_pool pl0_values;
+
+Value *pl0_value_pool::imm(int v, pl0_type_t dt) {
+    Value *& val = this->imms[key((uint32_t)v, dt)];
+    if (val == nullptr) {
+        val = this->arena.make<Value>(v, dt);
+    }
+    return val;
+}
+
+Value *pl0_value_pool::label(int label) {
+    Value *& val = this->labels[(uint64_t)(uint32_t)label];
+    if (val == nullptr) {
+        val = this->arena.make<Value>(label, pl0_type_t::INTEGER, Value::LABEL);
+    }
+    return val;
+}
+
+Value *pl0_value_pool::name(pl0_sym_t v, pl0_type_t dt) {
+    Value *& val = this->names[key(v.id, dt)];
+    if (val == nullptr) {
+        val = this->arena.make<Value>(v, dt);
+    }
+    return val;
+}
+
+Value *pl0_value_pool::name(std::string const & v, pl0_type_t dt) {
+    return this->name(pl0_symbols.intern(v), dt);
+}
+
+Value *pl0_value_pool::temp(int no, pl0_type_t dt) {
+    return this->arena.make<Value>(no, dt, Value::TEMP);
+}
+
+Value *pl0_value_pool::var(pl0_sym_t v, pl0_type_t dt, pl0_slot_t slot) {
+    Value *& val = this->vars[std::make_pair(key(v.id, dt), key(slot))];
+    if (val == nullptr) {
+        val = this->arena.make<Value>(v, dt);
+        val->slot = slot;
+    }
+    return val;
+}
+
+Value *pl0_value_pool::elem(int no, pl0_type_t dt, Value *base, Value *idx) {
+    return this->arena.make<Value>(no, dt, base, idx);
+}
+
+Value *pl0_value_pool::text(std::string const & s) {
+    auto it = this->texts.find(s);
+    if (it == this->texts.end()) {
+        it = this->texts.emplace(s, this->arena.make<Value>((int)this->texts.size(), pl0_type_t(), Value::TEXT)).first;
+        it->second->text = &it->first;
+    }
+    return it->second;
+}
+
+Value *pl0_value_pool::mark(Value::mark_t m) {
+    Value *& val = this->marks[m];
+    if (val == nullptr) {
+        val = this->arena.make<Value>((int)m, pl0_type_t(), Value::MARK);
+    }
+    return val;
+}
+
+Value *pl0_value_pool::retype(Value *v, pl0_type_t dt) {
+    if (v->dt == dt) {
+        return v;
+    }
+    switch (v->t) {
+        case Value::IMM: return this->imm(v->iv, dt);
+        case Value::LABEL: case Value::TEXT: case Value::MARK: return v;
+        case Value::TEMP: case Value::ELEM: return v; // a temporary keeps the type it's computed in.
+        default: return v->slot.placed() ? this->var(v->sv, dt, v->slot) : this->name(v->sv, dt);
+    }
+}
+
+void pl0_value_pool::release() {
+    this->arena.release();
+    this->imms.clear();
+    this->labels.clear();
+    this->names.clear();
+    this->vars.clear();
+    this->texts.clear();
+    for (auto && m: this->marks) {
+        m = nullptr;
+    }
+}
+
+char const *TAC::name(op_t op) {
+    static char const * const names[] = {
+        "", "program", "endprogram", "param", "paramref", "procedure", "function", "endproc", "endfunc",
+        "def", "allocret", "loadret", "exit", "label", "goto", "cmp", "call",
+        "=", "+", "-", "*", "/", "%", "=[]", "[]=", "read", "write_s", "write_e"
+    };
+    return names[op];
+}
+
+char const *TAC::name(cond_t cc) {
+    static char const * const names[] = { "jmp", "jl", "jle", "jg", "jge", "je", "jne" };
+    return names[cc];
+}
+
 std::string TAC::str() const {
-    if (op == "call") {
-        std::string s = "call " + rd->sv + " (";
+    if (op == CALL) {
+        std::string s = "call " + rd->sv.str() + " (";
         for (auto && a: args) {
             s = s + a.first->str() + (a.second ? " ref, ": ", ");
         }
-        s = s + ") " + (rt ? (" -> " + rt->sv) : "");
+        s = s + ") " + (rt ? (" -> " + rt->str()) : "");
         return s;
     }
+    else if (op == GOTO) {
+        return name(op) + string(" ") + name(cc) + " " + rd->str() + " ";
+    }
+    else if (op == PARAM || op == PARAMREF || op == DEF) {
+        // the declared type, from the operand and the length of an array: "def a integerarray 10".
+        pl0_type_t t(rd->dt.kind, rt ? rt->iv : -1);
+        return name(op) + string(" ") + rd->str() + " " + t.str() + " " + (rt ? rt->str() : "");
+    }
     else{
-        return op + " " + (rd ? rd->str() : "") + " " + (rs ? rs->str() : "") + " " + (rt ? rt->str() : "");
+        return name(op) + string(" ") + (rd ? rd->str() : "") + " " + (rs ? rs->str() : "") + " " + (rt ? rt->str() : "");
     }
 }
 
 int IRBuilder::makelabel() {
     return ++this->label;
 }
-string const IRBuilder::maketmp() {
-    return "~t" + to_string(++tmp);
-}
-string const IRBuilder::makeret() {
-    return "~ret" + to_string(++ret);
+int IRBuilder::maketmp() {
+    return ++this->tmp;
 }
 void IRBuilder::dump() const {
     for (auto ir: irs) {
@@ -152,18 +348,18 @@ struct IRBuilder irb;
 /* Global env. (symbol table) */
 
 
-variable::variable(std::string name, std::string dt, std::string type): name(name), dt(dt), type(type), len(-1) {}
-variable::variable(std::string name, std::string dt, std::string type, int len): name(name), dt(dt), type(type), len(len) {}
+variable::variable(pl0_sym_t name, pl0_type_t dt, pl0_type_t type): name(name), dt(dt), type(type), len(-1) {}
+variable::variable(pl0_sym_t name, pl0_type_t dt, pl0_type_t type, int len): name(name), dt(dt), type(type), len(len) {}
 bool operator == (variable const & a, variable const & b) {
     return a.name == b.name && a.type == b.type;
 }
 
-constant::constant(std::string name, int v, std::string dt): name(name), val(v), dt(dt) {}
+constant::constant(pl0_sym_t name, int v, pl0_type_t dt): name(name), val(v), dt(dt) {}
 bool operator == (constant const & a, constant const & b) {
     return a.name == b.name;
 }
 
-proc::proc(std::string name, std::vector<std::string> & param_t): name(name), param_t(param_t) {}
+proc::proc(pl0_sym_t name, std::vector<pl0_type_t> & param_t): name(name), param_t(param_t) {}
 bool operator == (proc const & a, proc const & b) {
     bool ans = a.name == b.name && a.param_t.size() == b.param_t.size();
     if (ans && a.param_t.size() > 0) {
@@ -174,7 +370,7 @@ bool operator == (proc const & a, proc const & b) {
     return ans;
 }
 
-func::func(std::string name, std::string rettype, std::vector<std::string> & param_t): name(name), rettype(rettype), param_t(param_t) {}
+func::func(pl0_sym_t name, pl0_type_t rettype, std::vector<pl0_type_t> & param_t): name(name), rettype(rettype), param_t(param_t) {}
 bool operator == (func const & a, func const & b) {
     bool ans = a.name == b.name && a.rettype == b.rettype && a.param_t.size() == b.param_t.size();
     if (ans && a.param_t.size() > 0) {
@@ -2,8 +2,15 @@
 #ifndef __PL0_AST_HPP__
 #define __PL0_AST_HPP__
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "patch.hpp"
 using namespace std;
@@ -51,18 +58,87 @@ struct pl0_ast_read_stmt;
 struct pl0_ast_write_stmt;
 struct pl0_ast_alnum;
 
+// A source location: the offset of a character in the source text. The nodes and the TACs keep just the offset,
+// its line and column are decoded through the line table of the source only when a diagnostic is printed.
+typedef uint32_t pl0_loc_t;
+// line and column of a location in the program being compiled (see `pl0_source`).
+std::pair<int, int> pl0_locate(pl0_loc_t loc);
+
+// An interned name: the index of the name in the symbol table of the compilation (`pl0_symbols`). Identifiers
+// are interned by the parser, so the later stages compare and look up names as integers. The symbol 0 is the
+// empty name.
+struct pl0_sym_t {
+    uint32_t id;
+    pl0_sym_t(): id(0) {}
+    explicit pl0_sym_t(uint32_t id): id(id) {}
+    bool empty() const { return this->id == 0; }
+    std::string const & str() const;
+    bool operator == (pl0_sym_t const & s) const { return this->id == s.id; }
+    bool operator != (pl0_sym_t const & s) const { return this->id != s.id; }
+    bool operator < (pl0_sym_t const & s) const { return this->id < s.id; }
+};
+
+class pl0_symbol_table {
+private:
+    std::deque<std::string> names; // a deque doesn't move its elements, `str()` references stay valid.
+    std::unordered_map<std::string, uint32_t> index;
+public:
+    pl0_symbol_table() { this->intern(""); }
+    pl0_sym_t intern(std::string const & name);
+    std::string const & name(pl0_sym_t const & sym) const { return this->names[sym.id]; }
+    // the last component of a mangled name (`_f_g` is `g`), the symbol itself if it isn't mangled.
+    pl0_sym_t suffix(pl0_sym_t const & sym);
+    size_t size() const { return this->names.size(); }
+};
+// the names of the program being compiled.
+extern pl0_symbol_table pl0_symbols;
+
+inline std::string const & pl0_sym_t::str() const { return pl0_symbols.name(*this); }
+
+// A data type: the scalar kind, the length of an array (-1 for a scalar) and whether it's passed by reference.
+// The operands which aren't data (names of procedures, literal strings, jump conditions) are VOID.
+struct pl0_type_t {
+    enum kind_t: uint8_t { VOID, INTEGER, CHAR } kind;
+    bool ref;
+    int32_t len;
+    pl0_type_t(kind_t kind = VOID, int32_t len = -1, bool ref = false): kind(kind), ref(ref), len(len) {}
+    bool scalar() const { return this->kind != VOID && this->len == -1; }
+    // type of the elements of an array.
+    pl0_type_t elem() const { return pl0_type_t(this->kind); }
+    pl0_type_t byref() const { return pl0_type_t(this->kind, this->len, true); }
+    // the whole descriptor in 32 bits, used as a hash key.
+    uint32_t bits() const { return (uint32_t)this->kind | (uint32_t)this->ref << 2 | (uint32_t)(this->len + 1) << 3; }
+    bool operator == (pl0_type_t const & t) const { return this->bits() == t.bits(); }
+    bool operator != (pl0_type_t const & t) const { return this->bits() != t.bits(); }
+    // name in the dumps: "integer", "chararray", "ref_integer" and so on.
+    std::string const & str() const;
+};
+
+// Where a variable lives at run time: the static depth of the frame holding it (1 for the program, one more for
+// each level of nesting, 0 if it has no slot yet), the offset from the base pointer of that frame, and whether the
+// slot holds the address of the variable (a parameter passed by reference) instead of its value.
+struct pl0_slot_t {
+    int depth;
+    int offset;
+    bool ref;
+    pl0_slot_t(int depth = 0, int offset = 0, bool ref = false): depth(depth), offset(offset), ref(ref) {}
+    bool placed() const { return this->depth > 0; }
+    bool operator == (pl0_slot_t const & s) const { return depth == s.depth && offset == s.offset && ref == s.ref; }
+    bool operator != (pl0_slot_t const & s) const { return !(*this == s); }
+};
+
 struct pl0_ast_program {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_prog *program;
-    pl0_ast_program(pair<int, int> loc, pl0_ast_prog *program): loc(loc), program(program) {}
+    pl0_ast_program(pl0_loc_t loc, pl0_ast_prog *program): loc(loc), program(program) {}
 };
 struct pl0_ast_prog {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_const_stmt *consts;
     struct pl0_ast_var_stmt *vars;
     std::vector<struct pl0_ast_executable *> exes;
     struct pl0_ast_compound_stmt *stmts;
-    pl0_ast_prog(pair<int, int> loc, struct pl0_ast_const_stmt *consts,
+    pl0_ast_prog(pl0_loc_t loc, struct pl0_ast_const_stmt *consts,
         struct pl0_ast_var_stmt *vars,
         std::vector<struct pl0_ast_executable *> const & exes,
         struct pl0_ast_compound_stmt *stmts)
@@ -71,56 +147,73 @@ struct pl0_ast_prog {
     }
 };
 struct pl0_ast_const_stmt {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<struct pl0_ast_const_define *> stmt;
-    pl0_ast_const_stmt(pair<int, int> loc, std::vector<pl0_ast_const_define *> const & stmt): loc(loc), stmt(stmt) {}
+    pl0_ast_const_stmt(pl0_loc_t loc, std::vector<pl0_ast_const_define *> const & stmt): loc(loc), stmt(stmt) {}
 };
 struct pl0_ast_const_define {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_identify *id;
     struct pl0_ast_constv *val;
-    pl0_ast_const_define(pair<int, int> loc, pl0_ast_identify *id, pl0_ast_constv *val): loc(loc), id(id), val(val) {}
+    pl0_ast_const_define(pl0_loc_t loc, pl0_ast_identify *id, pl0_ast_constv *val): loc(loc), id(id), val(val) {}
 };
 struct pl0_ast_constv {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     int val;
     enum DTYPE { INT, CHAR } dt;
-    pl0_ast_constv(pair<int, int> loc, int const val, DTYPE const dt): loc(loc), val(val), dt(dt) {}
+    pl0_ast_constv(pl0_loc_t loc, int const val, DTYPE const dt): loc(loc), val(val), dt(dt) {}
 };
 struct pl0_ast_charseq {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::string val;
-    pl0_ast_charseq(pair<int, int> loc, std::string const & val): loc(loc), val(val) {}
+    pl0_ast_charseq(pl0_loc_t loc, std::string const & val): loc(loc), val(val) {}
+};
+// What an identifier refers to, bound once by the resolver (`pl0_resolve_program`) so the TAC generator doesn't
+// look names up. The declarations live in the arena of the tree. An identifier that names a declaration is bound
+// to it as well, if the declaration is valid.
+struct pl0_ast_binding {
+    enum kind_t { UNBOUND, CONSTANT, VARIABLE, PROCEDURE, FUNCTION } kind;
+    // the frame slot of a variable, or of the return value of a function; only the static depth of the
+    // declaration for the others.
+    pl0_slot_t slot;
+    union {
+        struct constant const *val;
+        struct variable const *var;
+        struct proc const *proc;
+        struct func const *func;
+    };
+    pl0_ast_binding(): kind(UNBOUND), slot(), val(nullptr) {}
 };
 struct pl0_ast_identify {
-    pair<int, int> loc;
-    std::string id;
-    pl0_ast_identify(pair<int, int> loc, std::string const & id): loc(loc), id(id) {}
+    pl0_loc_t loc;
+    pl0_sym_t id;
+    pl0_ast_binding binding;
+    pl0_ast_identify(pl0_loc_t loc, std::string const & id): loc(loc), id(pl0_symbols.intern(id)) {}
 };
 struct pl0_ast_var_stmt {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<struct pl0_ast_var_define *> stmt;
-    pl0_ast_var_stmt(pair<int, int> loc, std::vector<pl0_ast_var_define *> const & stmt): loc(loc), stmt(stmt) {}
+    pl0_ast_var_stmt(pl0_loc_t loc, std::vector<pl0_ast_var_define *> const & stmt): loc(loc), stmt(stmt) {}
 };
 struct pl0_ast_var_define {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_type *type;
     std::vector<struct pl0_ast_identify *> ids;
-    pl0_ast_var_define(pair<int, int> loc, pl0_ast_type *type, std::vector<pl0_ast_identify *> const & ids): loc(loc), type(type), ids(ids) {}
+    pl0_ast_var_define(pl0_loc_t loc, pl0_ast_type *type, std::vector<pl0_ast_identify *> const & ids): loc(loc), type(type), ids(ids) {}
 };
 struct pl0_ast_type {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_primitive_type *type;
     int len; // if array, len = -1
-    pl0_ast_type(pair<int, int> loc, pl0_ast_primitive_type *type, int len): loc(loc), type(type), len(len) {}
+    pl0_ast_type(pl0_loc_t loc, pl0_ast_primitive_type *type, int len): loc(loc), type(type), len(len) {}
 };
 struct pl0_ast_primitive_type {
-    pair<int, int> loc;
-    std::string type;
-    pl0_ast_primitive_type(pair<int, int> loc, std::string type): loc(loc), type(type) {}
+    pl0_loc_t loc;
+    pl0_type_t dt;
+    pl0_ast_primitive_type(pl0_loc_t loc, pl0_type_t dt): loc(loc), dt(dt) {}
 };
 struct pl0_ast_executable {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     string const name = "pl0 executable object.";
     enum type_t {
         PROCEDURE, FUNCTION
@@ -128,80 +221,80 @@ struct pl0_ast_executable {
     type_t t;
     struct pl0_ast_procedure_stmt *proc;
     struct pl0_ast_function_stmt *func;
-    pl0_ast_executable(pair<int, int> loc, pl0_ast_procedure_stmt *proc): loc(loc), t(type_t::PROCEDURE), proc(proc), func(nullptr) {}
-    pl0_ast_executable(pair<int, int> loc, pl0_ast_function_stmt *func): loc(loc), t(type_t::FUNCTION), proc(nullptr), func(func) {}
+    pl0_ast_executable(pl0_loc_t loc, pl0_ast_procedure_stmt *proc): loc(loc), t(type_t::PROCEDURE), proc(proc), func(nullptr) {}
+    pl0_ast_executable(pl0_loc_t loc, pl0_ast_function_stmt *func): loc(loc), t(type_t::FUNCTION), proc(nullptr), func(func) {}
 };
 struct pl0_ast_procedure_stmt {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<std::pair<struct pl0_ast_procedure_header *, struct pl0_ast_prog *>> procs;
-    pl0_ast_procedure_stmt(pair<int, int> loc, std::vector<std::pair<pl0_ast_procedure_header *, pl0_ast_prog *>> const & procs): loc(loc), procs(procs) {}
+    pl0_ast_procedure_stmt(pl0_loc_t loc, std::vector<std::pair<pl0_ast_procedure_header *, pl0_ast_prog *>> const & procs): loc(loc), procs(procs) {}
 };
 struct pl0_ast_function_stmt {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<std::pair<struct pl0_ast_function_header *, struct pl0_ast_prog *>> funcs;
-    pl0_ast_function_stmt(pair<int, int> loc, std::vector<std::pair<pl0_ast_function_header *, pl0_ast_prog *>> const & funcs): loc(loc), funcs(funcs) {}
+    pl0_ast_function_stmt(pl0_loc_t loc, std::vector<std::pair<pl0_ast_function_header *, pl0_ast_prog *>> const & funcs): loc(loc), funcs(funcs) {}
 };
 struct pl0_ast_procedure_header {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_identify *id;
     struct pl0_ast_param_list *params;
-    pl0_ast_procedure_header(pair<int, int> loc, pl0_ast_identify *id, pl0_ast_param_list *params): loc(loc), id(id), params(params) {}
+    pl0_ast_procedure_header(pl0_loc_t loc, pl0_ast_identify *id, pl0_ast_param_list *params): loc(loc), id(id), params(params) {}
 };
 struct pl0_ast_function_header {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_identify *id;
     struct pl0_ast_param_list *params;
     struct pl0_ast_primitive_type *type;
-    pl0_ast_function_header(pair<int, int> loc, pl0_ast_identify *id, pl0_ast_param_list *params, pl0_ast_primitive_type *type): loc(loc), id(id), params(params), type(type) {}
+    pl0_ast_function_header(pl0_loc_t loc, pl0_ast_identify *id, pl0_ast_param_list *params, pl0_ast_primitive_type *type): loc(loc), id(id), params(params), type(type) {}
 };
 struct pl0_ast_param_list {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<struct pl0_ast_param_group *> params;
-    pl0_ast_param_list(pair<int, int> loc, vector<pl0_ast_param_group *> const & params): loc(loc), params(params) {}
+    pl0_ast_param_list(pl0_loc_t loc, vector<pl0_ast_param_group *> const & params): loc(loc), params(params) {}
 };
 struct pl0_ast_param_group {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<struct pl0_ast_identify *> ids;
     struct pl0_ast_primitive_type *type;
     bool is_ref;
-    pl0_ast_param_group(pair<int, int> loc, vector<pl0_ast_identify *> const & ids, pl0_ast_primitive_type *type, bool is_ref = false): loc(loc), ids(ids), type(type), is_ref(is_ref) {}
+    pl0_ast_param_group(pl0_loc_t loc, vector<pl0_ast_identify *> const & ids, pl0_ast_primitive_type *type, bool is_ref = false): loc(loc), ids(ids), type(type), is_ref(is_ref) {}
 };
 struct pl0_ast_stmt {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     enum type_t {
         STMT, ASSIGN_STMT, COND_STMT, CASE_STMT, CALL_PROC, COMPOUND_STMT, WRITE_STMT, READ_STMT, FOR_STMT, NULL_STMT, INHERIT
     };
     type_t t;
     // pl0_ast_stmt(): t(type_t::INHERIT), stmt(nullptr) {}
-    pl0_ast_stmt(pair<int, int> loc, type_t const t): loc(loc), t(t) {}
+    pl0_ast_stmt(pl0_loc_t loc, type_t const t): loc(loc), t(t) {}
     virtual ~pl0_ast_stmt() {}; // make pl0_ast_stmt polymorphic.
 };
 struct pl0_ast_null_stmt: pl0_ast_stmt {
-    pl0_ast_null_stmt(pair<int, int> loc): pl0_ast_stmt(loc, type_t::NULL_STMT) {}
+    pl0_ast_null_stmt(pl0_loc_t loc): pl0_ast_stmt(loc, type_t::NULL_STMT) {}
 }; // empty statement, not in grammar.
 struct pl0_ast_assign_stmt: pl0_ast_stmt {
     struct pl0_ast_identify *id;
     struct pl0_ast_expression *idx;
     struct pl0_ast_expression *val;
-    pl0_ast_assign_stmt(pair<int, int> loc, pl0_ast_identify *id, pl0_ast_expression *idx, pl0_ast_expression *val): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::ASSIGN_STMT), id(id), idx(idx), val(val) {}
+    pl0_ast_assign_stmt(pl0_loc_t loc, pl0_ast_identify *id, pl0_ast_expression *idx, pl0_ast_expression *val): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::ASSIGN_STMT), id(id), idx(idx), val(val) {}
 };
 struct pl0_ast_function_id {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_identify *id;
-    pl0_ast_function_id(pair<int, int> loc, pl0_ast_identify *id): loc(loc), id(id) {}
+    pl0_ast_function_id(pl0_loc_t loc, pl0_ast_identify *id): loc(loc), id(id) {}
 };
 struct pl0_ast_expression {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<std::pair<struct pl0_ast_addop *, struct pl0_ast_term *>> terms;
-    pl0_ast_expression(pair<int, int> loc, std::vector<std::pair<struct pl0_ast_addop *, struct pl0_ast_term *>> const & terms): loc(loc), terms(terms) {}
+    pl0_ast_expression(pl0_loc_t loc, std::vector<std::pair<struct pl0_ast_addop *, struct pl0_ast_term *>> const & terms): loc(loc), terms(terms) {}
 };
 struct pl0_ast_term {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<std::pair<struct pl0_ast_multop *, struct pl0_ast_factor *>> factors;
-    pl0_ast_term(pair<int, int> loc, std::vector<std::pair<pl0_ast_multop *, pl0_ast_factor *>> const & factors): loc(loc), factors(factors) {}
+    pl0_ast_term(pl0_loc_t loc, std::vector<std::pair<pl0_ast_multop *, pl0_ast_factor *>> const & factors): loc(loc), factors(factors) {}
 };
 struct pl0_ast_factor {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     enum type_t {
         ID = 1, UNSIGNED = 2, EXPR = 3, CALL_FUNC = 4, ARRAY_E = 5
     };
@@ -213,7 +306,7 @@ struct pl0_ast_factor {
         struct pl0_ast_call_func *call_func;
     } ptr;
     std::pair<struct pl0_ast_identify *, struct pl0_ast_expression *> arraye; // for array access.
-    pl0_ast_factor(pair<int, int> loc, type_t t, void *ptr): loc(loc), t(t) {
+    pl0_ast_factor(pl0_loc_t loc, type_t t, void *ptr): loc(loc), t(t) {
         switch (this->t) {
             case type_t::ID: this->ptr.id = static_cast<pl0_ast_identify *>(ptr); break;
             case type_t::EXPR: this->ptr.expr = static_cast<pl0_ast_expression *>(ptr); break;
@@ -222,90 +315,89 @@ struct pl0_ast_factor {
             default: cout << "unknown factor type: " << t << endl; throw(this->t);
         }
     }
-    pl0_ast_factor(pair<int, int> loc, std::pair<struct pl0_ast_identify *, struct pl0_ast_expression *> const & arraye): loc(loc), t(type_t::ARRAY_E), arraye(arraye) {}
+    pl0_ast_factor(pl0_loc_t loc, std::pair<struct pl0_ast_identify *, struct pl0_ast_expression *> const & arraye): loc(loc), t(type_t::ARRAY_E), arraye(arraye) {}
 };
 struct pl0_ast_call_func {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_identify *fn;
     struct pl0_ast_arg_list *args;
-    pl0_ast_call_func(pair<int, int> loc, pair<pl0_ast_identify *, pl0_ast_arg_list *> const & call): loc(loc), fn(call.first), args(call.second) {}
+    pl0_ast_call_func(pl0_loc_t loc, pair<pl0_ast_identify *, pl0_ast_arg_list *> const & call): loc(loc), fn(call.first), args(call.second) {}
 };
 struct pl0_ast_arg_list {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     std::vector<struct pl0_ast_arg *> args;
-    pl0_ast_arg_list(pair<int, int> loc, std::vector<struct pl0_ast_arg *> const & args): loc(loc), args(args) {}
+    pl0_ast_arg_list(pl0_loc_t loc, std::vector<struct pl0_ast_arg *> const & args): loc(loc), args(args) {}
 };
 struct pl0_ast_arg {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_expression *arg;
-    pl0_ast_arg(pair<int, int> loc, pl0_ast_expression *arg): loc(loc), arg(arg) {}
+    pl0_ast_arg(pl0_loc_t loc, pl0_ast_expression *arg): loc(loc), arg(arg) {}
 };
 struct pl0_ast_addop {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     enum {
         ADD, MINUS
     } OP;
     char op;
-    pl0_ast_addop(pair<int, int> loc, char const & op): loc(loc), op(op) {}
+    pl0_ast_addop(pl0_loc_t loc, char const & op): loc(loc), op(op) {}
 };
 struct pl0_ast_multop {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     enum {
         MULT, DIV
     } OP;
     char op;
-    pl0_ast_multop(pair<int, int> loc, char const & op): loc(loc), op(op) {}
+    pl0_ast_multop(pl0_loc_t loc, char const & op): loc(loc), op(op) {}
 };
 struct pl0_ast_condtion {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_expression *lhs;
     struct pl0_ast_comp_op *op;
     struct pl0_ast_expression *rhs;
-    pl0_ast_condtion(pair<int, int> loc, pl0_ast_expression *lhs, pl0_ast_comp_op *op, pl0_ast_expression *rhs): loc(loc), lhs(lhs), op(op), rhs(rhs) {}
+    pl0_ast_condtion(pl0_loc_t loc, pl0_ast_expression *lhs, pl0_ast_comp_op *op, pl0_ast_expression *rhs): loc(loc), lhs(lhs), op(op), rhs(rhs) {}
 };
 struct pl0_ast_comp_op {
-    pair<int, int> loc;
-    enum {
+    pl0_loc_t loc;
+    enum op_t {
         LT, LE, GT, GE, EQ, NE
-    } OP;
-    string op;
-    pl0_ast_comp_op(pair<int, int> loc, string const & op): loc(loc), op(op) {}
+    } op;
+    pl0_ast_comp_op(pl0_loc_t loc, op_t op): loc(loc), op(op) {}
 };
 struct pl0_ast_cond_stmt: pl0_ast_stmt {
     struct pl0_ast_condtion *cond;
     struct pl0_ast_stmt *then_block, *else_block;
-    pl0_ast_cond_stmt(pair<int, int> loc, pl0_ast_condtion *cond, pl0_ast_stmt *then_block, pl0_ast_stmt *else_block): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::COND_STMT), cond(cond), then_block(then_block), else_block(else_block) {}
+    pl0_ast_cond_stmt(pl0_loc_t loc, pl0_ast_condtion *cond, pl0_ast_stmt *then_block, pl0_ast_stmt *else_block): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::COND_STMT), cond(cond), then_block(then_block), else_block(else_block) {}
 };
 struct pl0_ast_case_stmt: pl0_ast_stmt {
     struct pl0_ast_expression *expr;
     std::vector<pl0_ast_case_term *> terms;
-    pl0_ast_case_stmt(pair<int, int> loc, pl0_ast_expression *expr, std::vector<pl0_ast_case_term *> const & terms): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::CASE_STMT), expr(expr), terms(terms) {}
+    pl0_ast_case_stmt(pl0_loc_t loc, pl0_ast_expression *expr, std::vector<pl0_ast_case_term *> const & terms): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::CASE_STMT), expr(expr), terms(terms) {}
 };
 struct pl0_ast_case_term {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     struct pl0_ast_constv *constv;
     struct pl0_ast_stmt *stmt;
-    pl0_ast_case_term(pair<int, int> loc, pl0_ast_constv *constv, pl0_ast_stmt *stmt): loc(loc), constv(constv), stmt(stmt) {}
+    pl0_ast_case_term(pl0_loc_t loc, pl0_ast_constv *constv, pl0_ast_stmt *stmt): loc(loc), constv(constv), stmt(stmt) {}
 };
 struct pl0_ast_for_stmt: pl0_ast_stmt {
     struct pl0_ast_identify *iter;
     struct pl0_ast_expression *initial, *end;
     struct pl0_ast_stmt *stmt;
     struct pl0_ast_constv *step;
-    pl0_ast_for_stmt(pair<int, int> loc, pl0_ast_identify *iter, pl0_ast_expression *initial, pl0_ast_expression *end, pl0_ast_stmt *stmt, pl0_ast_constv *step): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::FOR_STMT), iter(iter), initial(initial), end(end), stmt(stmt), step(step) {}
+    pl0_ast_for_stmt(pl0_loc_t loc, pl0_ast_identify *iter, pl0_ast_expression *initial, pl0_ast_expression *end, pl0_ast_stmt *stmt, pl0_ast_constv *step): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::FOR_STMT), iter(iter), initial(initial), end(end), stmt(stmt), step(step) {}
 };
 struct pl0_ast_call_proc: pl0_ast_stmt {
     struct pl0_ast_identify *id;
     struct pl0_ast_arg_list *args;
-    pl0_ast_call_proc(pair<int, int> loc, pl0_ast_identify *id, pl0_ast_arg_list *args):  pl0_ast_stmt(loc, pl0_ast_stmt::type_t::CALL_PROC), id(id), args(args) {}
+    pl0_ast_call_proc(pl0_loc_t loc, pl0_ast_identify *id, pl0_ast_arg_list *args):  pl0_ast_stmt(loc, pl0_ast_stmt::type_t::CALL_PROC), id(id), args(args) {}
 };
 struct pl0_ast_compound_stmt: pl0_ast_stmt {
     std::vector<struct pl0_ast_stmt *> stmt;
-    pl0_ast_compound_stmt(pair<int, int> loc, std::vector<struct pl0_ast_stmt *> const & stmt): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::COMPOUND_STMT), stmt(stmt) {}
+    pl0_ast_compound_stmt(pl0_loc_t loc, std::vector<struct pl0_ast_stmt *> const & stmt): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::COMPOUND_STMT), stmt(stmt) {}
 };
 struct pl0_ast_read_stmt: pl0_ast_stmt {
     std::vector<struct pl0_ast_identify *> ids;
-    pl0_ast_read_stmt(pair<int, int> loc, std::vector<struct pl0_ast_identify *> const & ids): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::READ_STMT), ids(ids) {}
+    pl0_ast_read_stmt(pl0_loc_t loc, std::vector<struct pl0_ast_identify *> const & ids): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::READ_STMT), ids(ids) {}
 };
 struct pl0_ast_write_stmt: pl0_ast_stmt {
     enum type_t {
@@ -316,28 +408,79 @@ struct pl0_ast_write_stmt: pl0_ast_stmt {
     type_t t;
     struct pl0_ast_charseq *str;
     struct pl0_ast_expression *expr;
-    pl0_ast_write_stmt(pair<int, int> loc, pl0_ast_charseq *str): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::WRITE_STMT), t(type_t::ONLY_STRING), str(str) {}
-    pl0_ast_write_stmt(pair<int, int> loc, pl0_ast_expression *expr): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::WRITE_STMT), t(type_t::ONLY_EXPR), expr(expr) {}
-    pl0_ast_write_stmt(pair<int, int> loc, pl0_ast_charseq *str, pl0_ast_expression *expr): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::WRITE_STMT), t(type_t::STRING_AND_EXPR), str(str), expr(expr) {}
+    pl0_ast_write_stmt(pl0_loc_t loc, pl0_ast_charseq *str): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::WRITE_STMT), t(type_t::ONLY_STRING), str(str) {}
+    pl0_ast_write_stmt(pl0_loc_t loc, pl0_ast_expression *expr): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::WRITE_STMT), t(type_t::ONLY_EXPR), expr(expr) {}
+    pl0_ast_write_stmt(pl0_loc_t loc, pl0_ast_charseq *str, pl0_ast_expression *expr): pl0_ast_stmt(loc, pl0_ast_stmt::type_t::WRITE_STMT), t(type_t::STRING_AND_EXPR), str(str), expr(expr) {}
 };
 struct pl0_ast_alnum {
-    pair<int, int> loc;
+    pl0_loc_t loc;
     char val;
-    pl0_ast_alnum(pair<int, int> loc, char val): loc(loc), val(val) {}
+    pl0_ast_alnum(pl0_loc_t loc, char val): loc(loc), val(val) {}
+};
+
+// Arena of the AST nodes of a compilation. A node is constructed in place at the top of the current block (a
+// pointer bump) and is never freed on its own: `release()` frees the whole tree at once, after running the
+// destructors of the nodes that own child vectors or strings.
+class pl0_ast_arena {
+private:
+    static size_t const block_size = 64 * 1024;
+    std::vector<char *> blocks;
+    char *top = nullptr, *limit = nullptr;
+    size_t bytes = 0;
+    std::vector<std::pair<void *, void (*)(void *)>> finalizers;
+    void *allocate(size_t size);
+    template<typename T>
+    static void destroy(void *node) { static_cast<T *>(node)->~T(); }
+public:
+    pl0_ast_arena() {}
+    pl0_ast_arena(pl0_ast_arena const &) = delete;
+    pl0_ast_arena & operator = (pl0_ast_arena const &) = delete;
+    ~pl0_ast_arena() { this->release(); }
+    template<typename T, typename... Args>
+    T *make(Args &&... args) {
+        T *node = new (this->allocate(sizeof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            this->finalizers.emplace_back(node, &pl0_ast_arena::destroy<T>);
+        }
+        return node;
+    }
+    // bytes taken by the nodes.
+    size_t size() const { return this->bytes; }
+    void release();
 };
+// the nodes of the tree being compiled.
+extern pl0_ast_arena pl0_arena;
 
 // TAC design
 struct Value {
-    enum TYPE { IMM, STR } t; // literal type: 1: immediate, 2: string.
+    // kind of operand: an immediate, a name (variable, procedure), a temporary, an array element loaded into a
+    // temporary, a label, a literal string or a marker.
+    enum TYPE { IMM, STR, TEMP, ELEM, LABEL, TEXT, MARK } t;
+    // markers, operands standing for no value: the label following a call, the node of a write in the DAG and the
+    // result of an expression that failed to compile.
+    enum mark_t { AFTER_CALL, WRITE_E, INVALID };
+    // IMM, LABEL: the value. TEMP, ELEM: the number of the temporary. TEXT: the number of the literal. MARK: the
+    // mark_t.
     int iv;
-    std::string sv, dt; // date type: 1: integer, 2: char.
-    Value(int v, std::string dt): t(TYPE::IMM), iv(v), dt(dt) {};
-    Value(std::string v, std::string dt): t(TYPE::STR), sv(v), dt(dt) {};
+    pl0_sym_t sv; // STR: the name.
+    std::string const *text = nullptr; // TEXT: the literal, owned by the pool.
+    Value *base = nullptr, *idx = nullptr; // ELEM: the array and the index.
+    pl0_type_t dt;
+    // STR: the slot of a variable, bound by the resolver. TEMP, ELEM: the stack slot the code generator spills
+    // it to, if ever.
+    pl0_slot_t slot;
+    Value(int v, pl0_type_t dt, TYPE t = TYPE::IMM): t(t), iv(v), dt(dt) {};
+    Value(std::string const & v, pl0_type_t dt, TYPE t = TYPE::STR): t(t), sv(pl0_symbols.intern(v)), dt(dt) {};
+    Value(pl0_sym_t v, pl0_type_t dt, TYPE t = TYPE::STR): t(t), sv(v), dt(dt) {};
+    Value(int no, pl0_type_t dt, Value *base, Value *idx): t(TYPE::ELEM), iv(no), base(base), idx(idx), dt(dt) {};
+    bool named() const { return t != TYPE::IMM && t != TYPE::LABEL; }
+    // identified by `iv` instead of `sv`.
+    bool numbered() const { return t != TYPE::STR; }
     std::string const str() const;
     bool operator == (Value const & v) const {
         bool res = t == v.t;
         if (res) {
-            if (t == TYPE::IMM) {
+            if (numbered()) {
                 res = res && iv == v.iv;
             }
             else {
@@ -347,43 +490,97 @@ struct Value {
         return res;
     }
     bool operator < (Value const & other) const {
-        return value() < other.value();
+        if (t != other.t) {
+            return t < other.t;
+        }
+        return numbered() ? iv < other.iv : sv < other.sv;
     }
     std::string value() const {
-        if (this->t == TYPE::IMM) {
+        if (!this->named()) {
             return to_string(this->iv);
         }
         else {
-            return this->sv;
+            return this->str();
         }
     }
 };
 
+// Operands of a compilation, allocated from an arena and released at once. Immediates, labels, names and variables
+// (by their slots as well, the same name may be declared in several procedures) are hash-consed into one object
+// each, so two of them are the same operand iff they're the same pointer.
+class pl0_value_pool {
+private:
+    pl0_ast_arena arena;
+    struct slot_hash {
+        size_t operator()(std::pair<uint64_t, uint64_t> const & k) const { return std::hash<uint64_t>()(k.first * 31 + k.second); }
+    };
+    std::unordered_map<uint64_t, Value *> imms, labels, names;
+    std::unordered_map<std::string, Value *> texts;
+    Value *marks[3] = {};
+    std::unordered_map<std::pair<uint64_t, uint64_t>, Value *, slot_hash> vars;
+    static uint64_t key(uint32_t v, pl0_type_t dt) { return (uint64_t)v << 32 | dt.bits(); }
+    static uint64_t key(pl0_slot_t slot) { return (uint64_t)slot.ref << 63 | (uint64_t)(uint32_t)slot.depth << 32 | (uint32_t)slot.offset; }
+public:
+    Value *imm(int v, pl0_type_t dt);
+    Value *label(int label);
+    Value *name(pl0_sym_t v, pl0_type_t dt);
+    Value *name(std::string const & v, pl0_type_t dt);
+    Value *temp(int no, pl0_type_t dt);
+    // a variable living at `slot`.
+    Value *var(pl0_sym_t v, pl0_type_t dt, pl0_slot_t slot);
+    Value *elem(int no, pl0_type_t dt, Value *base, Value *idx);
+    // a literal string, kept apart from the names so it never stands for an identifier.
+    Value *text(std::string const & s);
+    Value *mark(Value::mark_t m);
+    // the same operand with another data type.
+    Value *retype(Value *v, pl0_type_t dt);
+    // bytes taken by the operands.
+    size_t size() const { return this->arena.size(); }
+    void release();
+};
+// the operands of the program being compiled.
+extern pl0_value_pool pl0_values;
+
 struct TAC {
-    std::string op;
+    // opcodes, `name` gives the mnemonic printed in the dumps.
+    enum op_t: uint8_t {
+        NOP, PROGRAM, ENDPROGRAM, PARAM, PARAMREF, PROCEDURE, FUNCTION, ENDPROC, ENDFUNC,
+        DEF, ALLOCRET, LOADRET, EXIT, LABEL, GOTO, CMP, CALL,
+        ASSIGN, ADD, SUB, MUL, DIV, MOD, LOAD_ELEM, STORE_ELEM, READ, WRITE_S, WRITE_E
+    };
+    // condition of a GOTO, tested on the flags set by the last CMP.
+    enum cond_t: uint8_t { JMP, JL, JLE, JG, JGE, JE, JNE };
+    op_t op;
+    cond_t cc = JMP; // GOTO
     Value *rd, *rs, *rt;
     std::vector<pair<Value *, bool>> args;
-    TAC(std::string op, Value *rd, vector<pair<Value *, bool>> & args, Value *rt = nullptr): op(op), rd(rd), rs(nullptr), rt(rt), args(args) {}
-    TAC(std::string op, Value *rd, Value *rs = nullptr, Value *rt = nullptr): op(op), rd(rd), rs(rs), rt(rt) {}
+    pl0_loc_t loc = 0; // the statement the code is generated for.
+    TAC(op_t op, Value *rd, vector<pair<Value *, bool>> & args, Value *rt = nullptr): op(op), rd(rd), rs(nullptr), rt(rt), args(args) {}
+    TAC(op_t op, Value *rd, Value *rs = nullptr, Value *rt = nullptr): op(op), rd(rd), rs(rs), rt(rt) {}
+    TAC(cond_t cc, Value *label): op(GOTO), cc(cc), rd(label), rs(nullptr), rt(nullptr) {}
+    static char const *name(op_t op);
+    static char const *name(cond_t cc);
     std::string str() const;
 };
 
 /* IR builder. */
 struct IRBuilder {
 public:
-    int label = 0, tmp = 0, var = 0, ret = 0;
+    int label = 0, tmp = 0;
+    pl0_loc_t loc = 0; // location of the statement being translated, stamped on the emitted code.
     std::vector<struct TAC> irs;
+private:
+    void push(TAC const & c) { irs.emplace_back(c); irs.back().loc = loc; }
 public:
     IRBuilder() {}
-    void emitlabel(int label) { irs.emplace_back(TAC("label", new Value(label, "integer"))); }
-    void emit(std::string op, Value *rd, Value *rs = nullptr, Value *rt = nullptr) { irs.emplace_back(TAC(op, rd, rs, rt)); }
-    void emit(TAC c) { irs.emplace_back(c); }
-    void emit(std::string op, std::string rd) { irs.emplace_back(TAC(op, new Value(rd, "string"))); }
-    void emit(std::string op, std::string rd, std::string rdt, std::string rs, std::string rst) { irs.emplace_back(TAC(op, new Value(rd, rdt), new Value(rs, rst))); }
-    void emit(std::string op, Value *rd, vector<pair<Value *, bool>> & args, Value *rt = nullptr) { irs.emplace_back(TAC(op, rd, args, rt)); }
+    void emitlabel(int label) { push(TAC(TAC::LABEL, pl0_values.label(label))); }
+    void emitgoto(TAC::cond_t cc, int label) { push(TAC(cc, pl0_values.label(label))); }
+    void emit(TAC::op_t op, Value *rd, Value *rs = nullptr, Value *rt = nullptr) { push(TAC(op, rd, rs, rt)); }
+    void emit(TAC c) { push(c); }
+    void emit(TAC::op_t op, std::string rd) { push(TAC(op, pl0_values.name(rd, pl0_type_t()))); }
+    void emit(TAC::op_t op, Value *rd, vector<pair<Value *, bool>> & args, Value *rt = nullptr) { push(TAC(op, rd, args, rt)); }
     int makelabel();
-    string const maketmp();
-    string const makeret();
+    int maketmp();
     void dump() const;
 };
 
@@ -391,39 +588,39 @@ public:
 
 // variable.
 struct variable {
-    std::string name;
-    std::string dt, type;
+    pl0_sym_t name;
+    pl0_type_t dt, type; // type of the elements and the declared type.
     int len;
-    variable(): name(""), dt(""), len(-1) {}
-    variable(std::string, std::string dt, std::string type);
-    variable(std::string, std::string dt, std::string type, int);
+    variable(): name(), len(-1) {}
+    variable(pl0_sym_t, pl0_type_t dt, pl0_type_t type);
+    variable(pl0_sym_t, pl0_type_t dt, pl0_type_t type, int);
     std::string str() const {
-        return string("variable ") + name + " " + type;
+        return string("variable ") + name.str() + " " + type.str();
     }
 };
 
 // constant.
 struct constant {
-    std::string name;
+    pl0_sym_t name;
     int val;
-    std::string dt;
-    constant(): name(""), val(0), dt("") {}
-    constant(std::string, int, std::string dt);
+    pl0_type_t dt;
+    constant(): name(), val(0) {}
+    constant(pl0_sym_t, int, pl0_type_t dt);
     std::string str() const {
-        return string("constant ") + name + " " + to_string(val) + " " + dt;
+        return string("constant ") + name.str() + " " + to_string(val) + " " + dt.str();
     }
 };
 
 // procedure.
 struct proc {
-    std::string name;
-    std::vector<std::string> param_t;
-    proc(): name("") {}
-    proc(std::string, std::vector<std::string> &);
+    pl0_sym_t name;
+    std::vector<pl0_type_t> param_t;
+    proc(): name() {}
+    proc(pl0_sym_t, std::vector<pl0_type_t> &);
     std::string str() const {
-        std::string res = name + " :: ";
+        std::string res = name.str() + " :: ";
         for (auto && p: param_t) {
-            res = res + p + " -> ";
+            res = res + p.str() + " -> ";
         }
         return res;
     }
@@ -431,32 +628,17 @@ struct proc {
 
 // function.
 struct func {
-    std::string name, rettype;
-    std::vector<std::string> param_t;
-    func(): name(""), rettype("") {}
-    func(std::string, std::string, std::vector<std::string> &);
+    pl0_sym_t name;
+    pl0_type_t rettype;
+    std::vector<pl0_type_t> param_t;
+    func(): name() {}
+    func(pl0_sym_t, pl0_type_t, std::vector<pl0_type_t> &);
     std::string str() const {
-        std::string res = name + " :: ";
+        std::string res = name.str() + " :: ";
         for (auto && p: param_t) {
-            res = res + p + " -> ";
+            res = res + p.str() + " -> ";
         }
-        return res + rettype;
-    }
-};
-
-// location when generate assembly language code.
-struct LOC {
-    std::string name;
-    std::string offset; // offset from variable's base address to ebp register.
-    bool is_ref;
-    bool in_mem; // true: in memory, false: in register;
-    LOC(): name(""), offset(to_string(0x7fffffff)), is_ref(false), in_mem(false) {}
-    LOC(string name, int offset, bool is_ref = false): name(name), is_ref(is_ref), in_mem(false) {
-        this->offset = offset < 0 ? to_string(offset) : (string("+") + to_string(offset));
-    }
-    LOC(string name, std::string offset, bool is_ref = false): name(name), offset(offset), is_ref(is_ref), in_mem(false) {}
-    std::string str() {
-        return name + ": " + this->offset + " is_ref: " + to_string(is_ref) + " in_mem: " + to_string(in_mem);
+        return res + rettype.str();
     }
 };
 
@@ -470,22 +652,39 @@ struct IOOut {
     }
 };
 
+// Symbol table of a kind of entries, a stack of scopes. A procedure or a function is entered under its mangled
+// name (`_f_g` for `g` nested in `f`), and is found by either the mangled name or the last component of it.
+//
+// The entries are kept in a stack and indexed by a hash map from a name to the newest entry of that name; every
+// entry links to the entry it shadows under each of its names, so a lookup is a single probe and leaving a scope
+// restores the shadowed entries as it pops. The depth of the scope of an entry is recorded when it's pushed.
 template<typename T>
 class pl0_env {
 private:
+    struct link_t {
+        pl0_sym_t keys[2]; // the name and its suffix (empty if it's the name itself).
+        int shadows[2]; // the entries shadowed under the keys, plus one (0 is none).
+        int depth;
+    };
     std::vector<T> tb;
+    std::vector<link_t> links;
     std::vector<int> tags;
+    std::unordered_map<uint32_t, int> heads; // name -> the newest entry of the name, plus one (0 is none).
+    int newest(pl0_sym_t const & name) const {
+        auto iter = this->heads.find(name.id);
+        return iter == this->heads.end() ? -1 : iter->second - 1;
+    }
 public:
     pl0_env() { tags.emplace_back(0); }
     bool empty();
-    bool find(std::string const &, bool);
-    bool find(std::string const &, bool, T &);
+    bool find(pl0_sym_t const &, bool);
+    bool find(pl0_sym_t const &, bool, T &);
     void push(T const &);
     void pop();
     void tag();
     void detag();
     int depth();
-    int depth(std::string const &);
+    int depth(pl0_sym_t const &);
     void dump() {
         cout << ";; -----------------  Symbol Table  -------------------" << endl;
         for (auto && t: tb) {
@@ -499,46 +698,58 @@ template<typename T>
 bool pl0_env<T>::empty() { return this->tb.empty(); }
 
 template<typename T>
-bool pl0_env<T>::find(std::string const & name, bool cross, T & res) {
-    if (this->empty()) { return false; }
-    for (int i = this->tb.size()-1; i >= 0; --i) {
-        if (!cross && i < this->tags.back()) {
-            break;
-        }
-        if (this->tb[i].name == name || (this->tb[i].name.rfind('_') != this->tb[i].name.npos && this->tb[i].name.substr(this->tb[i].name.rfind('_')+1) == name)) {
-            res = this->tb[i];
-            return true;
-        }
+bool pl0_env<T>::find(pl0_sym_t const & name, bool cross, T & res) {
+    int i = this->newest(name);
+    if (i < 0 || (!cross && i < this->tags.back())) {
+        return false;
     }
-    return false;
+    res = this->tb[i];
+    return true;
 }
 
 template<typename T>
-bool pl0_env<T>::find(std::string const & name, bool cross) {
-    if (this->empty()) { return false; }
-    for (int i = this->tb.size()-1; i >= 0; --i) {
-        if (!cross && i < this->tags.back()) {
-            break;
-        }
-        if (this->tb[i].name == name || (this->tb[i].name.rfind('_') != this->tb[i].name.npos && this->tb[i].name.substr(this->tb[i].name.rfind('_')+1) == name)) {
-            return true;
-        }
-    }
-    return false;
+bool pl0_env<T>::find(pl0_sym_t const & name, bool cross) {
+    int i = this->newest(name);
+    return i >= 0 && (cross || i >= this->tags.back());
 }
 
 template<typename T>
-void pl0_env<T>::push(T const & e) { this->tb.emplace_back(e); }
+void pl0_env<T>::push(T const & e) {
+    pl0_sym_t suffix = pl0_symbols.suffix(e.name);
+    link_t link;
+    link.keys[0] = e.name;
+    link.keys[1] = suffix == e.name ? pl0_sym_t() : suffix;
+    link.depth = this->depth();
+    for (int k = 0; k < 2; ++k) {
+        link.shadows[k] = 0;
+        if (k == 0 || !link.keys[k].empty()) {
+            int & head = this->heads[link.keys[k].id];
+            link.shadows[k] = head;
+            head = this->tb.size() + 1;
+        }
+    }
+    this->tb.emplace_back(e);
+    this->links.emplace_back(link);
+}
 
 template<typename T>
-void pl0_env<T>::pop() { this->tb.pop_back(); }
+void pl0_env<T>::pop() {
+    link_t const & link = this->links.back();
+    for (int k = 1; k >= 0; --k) {
+        if (k == 0 || !link.keys[k].empty()) {
+            this->heads[link.keys[k].id] = link.shadows[k];
+        }
+    }
+    this->tb.pop_back();
+    this->links.pop_back();
+}
 
 template<typename T>
 void pl0_env<T>::tag() { this->tags.emplace_back(this->tb.size()); }
 
 template<typename T>
 void pl0_env<T>::detag() {
-    while (tb.size() > (size_t)tags.back()) { tb.pop_back(); }
+    while (tb.size() > (size_t)tags.back()) { this->pop(); }
     tags.pop_back();
 }
 
@@ -548,18 +759,9 @@ int pl0_env<T>::depth() {
 }
 
 template<typename T>
-int pl0_env<T>::depth(std::string const & name) {
-    if (tb.empty()) { return -1; } // doesn't exist.
-    for (int i = this->tb.size()-1; i >= 0; --i) {
-        if (this->tb[i].name == name || (this->tb[i].name.rfind('_') != this->tb[i].name.npos && this->tb[i].name.substr(this->tb[i].name.rfind('_')+1) == name)) {
-            for (int j = this->tags.size()-1; j >= 0; --j) {
-                if (i >= this->tags[j]) {
-                    return j;
-                }
-            }
-        }
-    }
-    return -1; // NOT FOUND
+int pl0_env<T>::depth(pl0_sym_t const & name) {
+    int i = this->newest(name);
+    return i < 0 ? -1 : this->links[i].depth; // -1: NOT FOUND
 }
 
 #endif /* __PL0_AST_HPP__ */
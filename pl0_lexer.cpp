@@ -0,0 +1,58 @@
+/**
+ * Lexer for PL0 grammar.
+ */
+
+#include "charset.hpp"
+#include "pl0_lexer.hpp"
+using namespace std;
+
+vector<token_t> pl0_lexer::lex(input_t const & text) {
+    static charset_scanner const spaces(space_set);
+    static charset_scanner const word(alnum_set);
+    static charset_scanner const digits(digit_set);
+    static charset_scanner const string_chars(print_set - charset_t::of("\""));
+    static charset_t const symbols = charset_t::of("+-*/%()[],;:.=<>");
+
+    slice_t src = text.take(text.length());
+    char const *p = src.ptr;
+    size_t n = src.len, i = spaces.span(p, n);
+    vector<token_t> tokens;
+    tokens.reserve(n / 4 + 1);
+    while (i < n) {
+        size_t len = 1;
+        int kind = ERROR;
+        char c = p[i];
+        if (alpha_set.test(c)) {
+            kind = WORD;
+            len = word.span(p + i, n - i);
+        }
+        else if (digit_set.test(c)) {
+            kind = UNSIGNED;
+            len = digits.span(p + i, n - i);
+        }
+        else if (c == '\'') {
+            if (i + 2 < n && alnum_set.test(p[i + 1]) && p[i + 2] == '\'') {
+                kind = CHAR;
+                len = 3;
+            }
+        }
+        else if (c == '"') {
+            size_t k = string_chars.span(p + i + 1, n - i - 1);
+            if (i + k + 1 < n && p[i + k + 1] == '"') {
+                kind = STRING;
+                len = k + 2;
+            }
+        }
+        else if (symbols.test(c)) {
+            kind = SYMBOL;
+            char d = i + 1 < n ? p[i + 1] : '\0';
+            if ((c == ':' && d == '=') || (c == '<' && (d == '=' || d == '>')) || (c == '>' && d == '=')) {
+                len = 2;
+            }
+        }
+        tokens.emplace_back(token_t{kind, slice_t(p + i, len), i});
+        i = i + len;
+        i = i + spaces.span(p + i, n - i);
+    }
+    return tokens;
+}
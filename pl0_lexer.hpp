@@ -0,0 +1,33 @@
+#ifndef __PL0_LEXER_HPP__
+#define __PL0_LEXER_HPP__
+
+#include <vector>
+#include "input_t.hpp"
+#include "parse_tool.hpp"
+using namespace std;
+
+// Lexer for PL0: splits the source into words (keywords and identifiers), unsigned integers, characters
+// ('a'), strings ("abc") and operators in one pass, whitespace is dropped. A character that can't start any
+// token becomes an ERROR token, no parser matches it.
+struct pl0_lexer {
+    enum kind_t {
+        WORD, // keywords and identifiers, told apart by the parser.
+        UNSIGNED,
+        CHAR,
+        STRING,
+        SYMBOL, // operators and punctuations.
+        ERROR
+    };
+    static vector<token_t> lex(input_t const & text);
+};
+
+using pl0_input_t = token_input_t<pl0_lexer>;
+
+// set the source text of the program being compiled, `pl0_locate` decodes the locations of its nodes.
+void pl0_source(input_t const & text);
+
+// grammar rules of PL0, over tokens.
+template<typename T>
+using pl0_parser_t = parser_t<T, pl0_input_t>;
+
+#endif /* __PL0_LEXER_HPP__ */
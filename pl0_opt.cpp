@@ -47,68 +47,76 @@ void BasicBlock::setSuffix(std::vector<int> & suffix) {
     this->suffix = suffix;
 }
 
+// the instructions a DAG is built for end with a branch, a call or the end of a procedure.
+static bool pl0_dag_end(TAC::op_t op) {
+    switch (op) {
+        case TAC::CMP: case TAC::GOTO: case TAC::CALL:
+        case TAC::LOADRET: case TAC::EXIT: case TAC::ENDPROC:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void BasicBlock::buildDAG() {
     size_t p = this->s;
     int rd, rs, rt, t;
-    for (p = 1; code[p].op != "cmp" && code[p].op != "goto" && code[p].op != "call"
-            && code[p].op != "loadret" && code[p].op != "exit" && code[p].op != "endproc"; ++p)
-    {
-        if (code[p].op == "*" || code[p].op == "/" || code[p].op == "%"
-                || code[p].op == "+" || code[p].op == "-"
-                || code[p].op == "cmp"
-                || code[p].op == "=[]" || code[p].op == "[]=") {
-            rs = findNode(code[p].rs);
-            setMap(code[p].rs, rs);
-            rt = findNode(code[p].rt);
-            setMap(code[p].rt, rt);
-            rd = findNode(code[p].op, code[p].rd, rs, rt);
-            setMap(code[p].rd, rd);
-        }
-        else if (code[p].op == "=") {
-            // rs = findNode(code[p].rs);
-            // setMap(code[p].rs, rs);
-            // setMap(code[p].rd, rs);
-            code[p].rt = new Value(0, "integer");
-            rs = findNode(code[p].rs);
-            setMap(code[p].rs, rs);
-            rt = findNode(code[p].rt);
-            setMap(code[p].rt, rt);
-            rd = findNode(code[p].op, code[p].rd, rs, rt);
-            setMap(code[p].rd, rd);
-        }
-        else if (code[p].op == "write_s") {
-            IOBuf.emplace_back(make_pair(p, code[p]));
-        }
-        else if (code[p].op == "write_e") {
-            rd = findNode(code[p].rd);
-            t = G.size();
-            G.emplace_back(DAGNode(t, "write_e", new Value("~write_e", "cmd"), rd, p));
-            G[rd].moreFa();
-        }
-        else if (code[p].op == "read") {
-            rd = findNode(code[p].rd);
-            t = G.size();
-            G.emplace_back(DAGNode(t, "read", code[p].rd, rd, p));
-            G[rd].moreFa();
-            setMap(code[p].rd, t);
+    for (p = 1; !pl0_dag_end(code[p].op); ++p) {
+        switch (code[p].op) {
+            case TAC::ASSIGN:
+                // rs = findNode(code[p].rs);
+                // setMap(code[p].rs, rs);
+                // setMap(code[p].rd, rs);
+                // built as a binary operation with 0.
+                code[p].rt = pl0_values.imm(0, pl0_type_t::INTEGER);
+                // fall through
+            case TAC::MUL: case TAC::DIV: case TAC::MOD:
+            case TAC::ADD: case TAC::SUB:
+            case TAC::CMP:
+            case TAC::LOAD_ELEM: case TAC::STORE_ELEM:
+                rs = findNode(code[p].rs);
+                setMap(code[p].rs, rs);
+                rt = findNode(code[p].rt);
+                setMap(code[p].rt, rt);
+                rd = findNode(code[p].op, code[p].rd, rs, rt);
+                setMap(code[p].rd, rd);
+                break;
+            case TAC::WRITE_S:
+                IOBuf.emplace_back(make_pair(p, code[p]));
+                break;
+            case TAC::WRITE_E:
+                rd = findNode(code[p].rd);
+                t = G.size();
+                G.emplace_back(DAGNode(t, TAC::WRITE_E, pl0_values.mark(Value::WRITE_E), rd, p));
+                G[rd].moreFa();
+                break;
+            case TAC::READ:
+                rd = findNode(code[p].rd);
+                t = G.size();
+                G.emplace_back(DAGNode(t, TAC::READ, code[p].rd, rd, p));
+                G[rd].moreFa();
+                setMap(code[p].rd, t);
+                break;
+            default:
+                break;
         }
     }
     this->t = p;
 }
 
 int BasicBlock::findNode(Value *val) {
-    int k = record.count(*val);
-    if (k == 0) {
-        k = G.size();
+    auto iter = record.find(val);
+    if (iter == record.end()) {
+        int k = G.size();
         G.emplace_back(DAGNode(k, val));
         return k;
     }
     else {
-        return record[*val];
+        return iter->second;
     }
 }
 
-int BasicBlock::findNode(std::string op, Value *val, int rs, int rt) {
+int BasicBlock::findNode(TAC::op_t op, Value *val, int rs, int rt) {
     // find op and target.
     auto iter = std::find_if(G.begin(), G.end(), [&](DAGNode & node) {
         return op == node.op && rs == node.lhs && rt == node.rhs;
@@ -125,9 +133,9 @@ int BasicBlock::findNode(std::string op, Value *val, int rs, int rt) {
 }
 
 void BasicBlock::setMap(Value *val, int node) {
-    auto iter = record.find(*val);
+    auto iter = record.find(val);
     if (iter == record.end()) {
-        record[*val] = node;
+        record[val] = node;
         G[node].addItem(val);
     }
     else if (iter->second == node) {
@@ -136,14 +144,14 @@ void BasicBlock::setMap(Value *val, int node) {
     else {
         auto it = G[iter->second].items.begin();
         while (it != G[iter->second].items.end()) {
-            if (*(*it) == *val) {
+            if (*it == val) {
                 it = G[iter->second].items.erase(it);
             }
             else {
                 it++;
             }
         }
-        record[*val] = node;
+        record[val] = node;
         G[node].addItem(val);
     }
 }
@@ -166,7 +174,7 @@ void BasicBlock::solveDAG() {
                 if (node.lhs != -1) {
                     t_nodes[node.lhs].lessFa();
                 }
-                if (node.op != "write_e" && node.op != "read" && node.rhs != -1) {
+                if (node.op != TAC::WRITE_E && node.op != TAC::READ && node.rhs != -1) {
                     t_nodes[node.rhs].lessFa();
                 }
                 t_nodes.erase((++iter).base());
@@ -198,7 +206,7 @@ void BasicBlock::solveDAG() {
         auto iter = G[node].items.begin();
         while (iter != G[node].items.end()) {
             if (*iter != G[node].item && (*iter)->t != Value::TYPE::IMM) {
-                irs.push_back(TAC("=", *iter, G[node].item));
+                irs.push_back(TAC(TAC::ASSIGN, *iter, G[node].item));
             }
             iter++;
         }
@@ -208,6 +216,13 @@ void BasicBlock::solveDAG() {
         irs.emplace_back(this->IOBuf[0].second);
         this->IOBuf.erase(IOBuf.begin());
     }
+    // the code rebuilt from the DAG mixes the statements of the range, it's located at the first of them.
+    pl0_loc_t loc = this->s < this->t ? this->code[this->s].loc : 0;
+    for (int i = this->s; i < (int)irs.size(); ++i) {
+        if (irs[i].loc == 0) {
+            irs[i].loc = loc;
+        }
+    }
     for (size_t i = t; i < this->code.size(); ++i) {
         irs.emplace_back(this->code[i]);
     }
@@ -215,35 +230,26 @@ void BasicBlock::solveDAG() {
 }
 
 void BasicBlock::trans(std::vector<TAC> & irs, int nno) {
-    if (G[nno].op == "=") {
-        irs.emplace_back(TAC(G[nno].op, G[nno].item, G[G[nno].lhs].item));
-    }
-    else if (G[nno].op == "read") {
-        while (!this->IOBuf.empty()) {
-            if (this->IOBuf[0].first < G[nno].rhs) {
-                irs.emplace_back(this->IOBuf[0].second);
-                this->IOBuf.erase(IOBuf.begin());
-            }
-            else {
-                break;
-            }
-        }
-        irs.emplace_back(TAC("read", G[G[nno].lhs].item));
-    }
-    else if (G[nno].op == "write_e") {
-        while (!this->IOBuf.empty()) {
-            if (this->IOBuf[0].first < G[nno].rhs) {
-                irs.emplace_back(this->IOBuf[0].second);
-                this->IOBuf.erase(IOBuf.begin());
-            }
-            else {
-                break;
+    switch (G[nno].op) {
+        case TAC::ASSIGN:
+            irs.emplace_back(TAC(G[nno].op, G[nno].item, G[G[nno].lhs].item));
+            break;
+        case TAC::READ: case TAC::WRITE_E:
+            // flush the output before it.
+            while (!this->IOBuf.empty()) {
+                if (this->IOBuf[0].first < G[nno].rhs) {
+                    irs.emplace_back(this->IOBuf[0].second);
+                    this->IOBuf.erase(IOBuf.begin());
+                }
+                else {
+                    break;
+                }
             }
-        }
-        irs.emplace_back(TAC("write_e", G[G[nno].lhs].item));
-    }
-    else {
-        irs.emplace_back(TAC(G[nno].op, G[nno].item, G[G[nno].lhs].item, G[G[nno].rhs].item));
+            irs.emplace_back(TAC(G[nno].op, G[G[nno].lhs].item));
+            break;
+        default:
+            irs.emplace_back(TAC(G[nno].op, G[nno].item, G[G[nno].lhs].item, G[G[nno].rhs].item));
+            break;
     }
 }
 
@@ -251,14 +257,14 @@ void BasicBlock::releaseLeaf(std::vector<TAC> & irs, Value *item) {
     auto iter = G.begin();
     while (iter != G.end()) {
         DAGNode & node = *iter; // reference.
-        if (node.leaf && record[*item] != node.no) {
+        if (node.leaf && record[item] != node.no) {
             if (node.item == item && !node.items.empty()) {
                 auto i_iter = node.items.begin();
                 node.item = *i_iter;
                 node.items.erase(i_iter);
                 releaseLeaf(irs, node.item);
-                if (node.item->str() != item->str()) {
-                    irs.push_back(TAC("=", node.item, item));
+                if (node.item != item) {
+                    irs.push_back(TAC(TAC::ASSIGN, node.item, item));
                 }
             }
         }
@@ -277,53 +283,59 @@ static int pl0_block_helper(std::vector<TAC> & code, std::vector<BasicBlock> & b
         std::map<int, std::vector<int>> & pres, std::map<int, std::vector<int>> & sufs)
 {
     BasicBlock header(0, false);
-    while (code[p].op == "param" || code[p].op == "paramref") {
+    while (code[p].op == TAC::PARAM || code[p].op == TAC::PARAMREF) {
         header.push(code[p++]);
     }
     header.push(code[p++]); // function or procedure.
-    while (code[p].op == "def" || code[p].op == "allocret") {
+    while (code[p].op == TAC::DEF || code[p].op == TAC::ALLOCRET) {
         header.push(code[p++]);
     }
     int hidx = bbs.size();
     bbs.emplace_back(header);
-    while (code[p].op == "param" || code[p].op == "paramref"
-            || code[p].op == "function" || code[p].op == "procedure") {
+    while (code[p].op == TAC::PARAM || code[p].op == TAC::PARAMREF
+            || code[p].op == TAC::FUNCTION || code[p].op == TAC::PROCEDURE) {
         p = pl0_block_helper(code, bbs, p, pres, sufs);
     }
     bbs[hidx].setBegin(code[p].rd->iv);
 
-    while (code[p].op != "endproc" && code[p].op != "endfunc") {
+    while (code[p].op != TAC::ENDPROC && code[p].op != TAC::ENDFUNC) {
         BasicBlock body(code[p].rd->iv, true);
         body.push(code[p++]);
-        while (code[p].op != "goto" && code[p].op != "call"
-                && code[p].op != "endproc" && code[p].op != "endfunc") {
-            if (code[p].op == "cmp") {
-                sufs[body.no].emplace_back(code[p].rd->iv);
-                pres[code[p].rd->iv].emplace_back(body.no);
-            }
-            if (code[p].op == "def") {
-                // add temporary variable to symbol table.
-                bbs[hidx].push(code[p++]);
+        bool last = false;
+        while (!last) {
+            switch (code[p].op) {
+                case TAC::CMP:
+                    sufs[body.no].emplace_back(code[p].rd->iv);
+                    pres[code[p].rd->iv].emplace_back(body.no);
+                    body.push(code[p++]);
+                    break;
+                case TAC::DEF:
+                    // add temporary variable to symbol table.
+                    bbs[hidx].push(code[p++]);
+                    break;
+                case TAC::GOTO:
+                    // goto label
+                    sufs[body.no].emplace_back(code[p].rd->iv);
+                    pres[code[p].rd->iv].emplace_back(body.no);
+                    body.push(code[p++]);
+                    last = true;
+                    break;
+                case TAC::CALL:
+                    // call ... -> ...
+                    // label: 
+                    body.push(code[p++]);
+                    sufs[body.no].emplace_back(code[p].rd->iv);
+                    pres[code[p].rd->iv].emplace_back(body.no);
+                    last = true;
+                    break;
+                case TAC::ENDPROC: case TAC::ENDFUNC:
+                    body.push(code[p]);
+                    last = true;
+                    break;
+                default:
+                    body.push(code[p++]);
+                    break;
             }
-            else {
-                body.push(code[p++]);
-            }
-        }
-        if (code[p].op == "goto") {
-            // goto label
-            sufs[body.no].emplace_back(code[p].rs->iv);
-            pres[code[p].rs->iv].emplace_back(body.no);
-            body.push(code[p++]);
-        }
-        else if (code[p].op == "call") {
-            // call ... -> ...
-            // label: 
-            body.push(code[p++]);
-            sufs[body.no].emplace_back(code[p].rd->iv);
-            pres[code[p].rd->iv].emplace_back(body.no);
-        }
-        else {
-            body.push(code[p]);
         }
 
         bbs.emplace_back(body);
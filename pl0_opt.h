@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include "pl0_ast.hpp"
 #include "patch.hpp"
@@ -14,17 +15,17 @@ struct DAGNode {
     bool used, leaf;
     Value *item;
     std::vector<Value *> items;
-    string op;
+    TAC::op_t op;
     int lhs, rhs;
-    DAGNode(int no, Value *val): no(no), fa(0), used(false), leaf(true), item(val), op(""), lhs(-1), rhs(-1) {
+    DAGNode(int no, Value *val): no(no), fa(0), used(false), leaf(true), item(val), op(TAC::NOP), lhs(-1), rhs(-1) {
         // ...
     }
-    DAGNode(int no, std::string op, Value *val, int lhs, int rhs): no(no), fa(0), leaf(false), item(val), op(op), lhs(lhs), rhs(rhs) {
+    DAGNode(int no, TAC::op_t op, Value *val, int lhs, int rhs): no(no), fa(0), leaf(false), item(val), op(op), lhs(lhs), rhs(rhs) {
         // ...
     }
     string const str() const {
         string ans = string("Node ") + to_string(no) + string(", fa~") + to_string(fa) + " : ";
-        ans += op + " ";
+        ans += string(TAC::name(op)) + " ";
         ans += to_string(lhs) + " " + to_string(rhs) + " -> [" + item->str() + ", ";
         for (auto && v: items) {
             ans += v->str() + ", ";
@@ -48,7 +49,7 @@ public:
     std::vector<TAC> code;
     std::vector<int> prefix, suffix;
     std::vector<DAGNode> G;
-    std::map<Value, int> record;
+    std::unordered_map<Value const *, int> record; // operands are hash-consed, see `pl0_value_pool`.
     std::vector<std::pair<int, TAC>> IOBuf;
 public:
     BasicBlock(int const no, bool const canopt): no(no), canopt(canopt), is_end(false), begin(0), end(0), s(1), t(-1) {}
@@ -64,7 +65,7 @@ private:
     void buildDAG();
     void addNode();
     int findNode(Value *);
-    int findNode(std::string op, Value *val, int lhs, int rhs);
+    int findNode(TAC::op_t op, Value *val, int lhs, int rhs);
     void trans(std::vector<TAC> & irs, int nno);
     void releaseLeaf(std::vector<TAC> & irs, Value *item);
     void setMap(Value *, int);
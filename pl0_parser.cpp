@@ -13,49 +13,50 @@
 #include "combinator.hpp"
 
 #include "pl0_ast.hpp"
-
-extern parser_t<pl0_ast_program *> pl0_program;
-extern parser_t<pl0_ast_prog *> pl0_prog;
-extern parser_t<pl0_ast_const_stmt *> pl0_const_stmt;
-extern parser_t<pl0_ast_const_define *> pl0_const_define;
-extern parser_t<pl0_ast_constv *> pl0_const;
-extern parser_t<pl0_ast_constv *> pl0_char;
-extern parser_t<pl0_ast_charseq *> pl0_charseq;
-extern parser_t<pl0_ast_constv *> pl0_unsigned;
-extern parser_t<pl0_ast_identify *> pl0_identify;
-extern parser_t<pl0_ast_var_stmt *> pl0_var_stmt;
-extern parser_t<pl0_ast_var_define *> pl0_var_define;
-extern parser_t<pl0_ast_type *> pl0_type;
-extern parser_t<pl0_ast_primitive_type *> pl0_primitive_type;
-extern parser_t<pl0_ast_executable *> pl0_executable;
-extern parser_t<pl0_ast_procedure_stmt *> pl0_procedure_stmt;
-extern parser_t<pl0_ast_function_stmt *> pl0_function_stmt;
-extern parser_t<pl0_ast_procedure_header *> pl0_procedure_header;
-extern parser_t<pl0_ast_function_header *> pl0_function_header;
-extern parser_t<pl0_ast_param_list *> pl0_param_list;
-extern parser_t<pl0_ast_param_group *> pl0_param_group;
-extern parser_t<pl0_ast_stmt *> pl0_stmt;
-extern parser_t<pl0_ast_null_stmt *> pl0_null_stmt; // empty statement, not in grammar.
-extern parser_t<pl0_ast_assign_stmt *> pl0_assign_stmt;
-extern parser_t<pl0_ast_function_id *> pl0_function_id;
-extern parser_t<pl0_ast_expression *> pl0_expression;
-extern parser_t<pl0_ast_term *> pl0_term;
-extern parser_t<pl0_ast_factor *> pl0_factor;
-extern parser_t<pl0_ast_call_func *> pl0_call_func;
-extern parser_t<pl0_ast_arg_list *> pl0_arg_list;
-extern parser_t<pl0_ast_arg *> pl0_arg;
-extern parser_t<pl0_ast_addop *> pl0_addop;
-extern parser_t<pl0_ast_multop *> pl0_multop;
-extern parser_t<pl0_ast_condtion *> pl0_condition;
-extern parser_t<pl0_ast_comp_op *> pl0_comp_op;
-extern parser_t<pl0_ast_cond_stmt *> pl0_cond_stmt;
-extern parser_t<pl0_ast_case_stmt *> pl0_case_stmt;
-extern parser_t<pl0_ast_case_term *> pl0_case_term;
-extern parser_t<pl0_ast_for_stmt *> pl0_for_stmt;
-extern parser_t<pl0_ast_call_proc *> pl0_call_proc;
-extern parser_t<pl0_ast_compound_stmt *> pl0_compound_stmt;
-extern parser_t<pl0_ast_read_stmt *> pl0_read_stmt;
-extern parser_t<pl0_ast_write_stmt *> pl0_write_stmt;
+#include "pl0_lexer.hpp"
+
+extern pl0_parser_t<pl0_ast_program *> pl0_program;
+extern pl0_parser_t<pl0_ast_prog *> pl0_prog;
+extern pl0_parser_t<pl0_ast_const_stmt *> pl0_const_stmt;
+extern pl0_parser_t<pl0_ast_const_define *> pl0_const_define;
+extern pl0_parser_t<pl0_ast_constv *> pl0_const;
+extern pl0_parser_t<pl0_ast_constv *> pl0_char;
+extern pl0_parser_t<pl0_ast_charseq *> pl0_charseq;
+extern pl0_parser_t<pl0_ast_constv *> pl0_unsigned;
+extern pl0_parser_t<pl0_ast_identify *> pl0_identify;
+extern pl0_parser_t<pl0_ast_var_stmt *> pl0_var_stmt;
+extern pl0_parser_t<pl0_ast_var_define *> pl0_var_define;
+extern pl0_parser_t<pl0_ast_type *> pl0_type;
+extern pl0_parser_t<pl0_ast_primitive_type *> pl0_primitive_type;
+extern pl0_parser_t<pl0_ast_executable *> pl0_executable;
+extern pl0_parser_t<pl0_ast_procedure_stmt *> pl0_procedure_stmt;
+extern pl0_parser_t<pl0_ast_function_stmt *> pl0_function_stmt;
+extern pl0_parser_t<pl0_ast_procedure_header *> pl0_procedure_header;
+extern pl0_parser_t<pl0_ast_function_header *> pl0_function_header;
+extern pl0_parser_t<pl0_ast_param_list *> pl0_param_list;
+extern pl0_parser_t<pl0_ast_param_group *> pl0_param_group;
+extern pl0_parser_t<pl0_ast_stmt *> pl0_stmt;
+extern pl0_parser_t<pl0_ast_null_stmt *> pl0_null_stmt; // empty statement, not in grammar.
+extern pl0_parser_t<pl0_ast_assign_stmt *> pl0_assign_stmt;
+extern pl0_parser_t<pl0_ast_function_id *> pl0_function_id;
+extern pl0_parser_t<pl0_ast_expression *> pl0_expression;
+extern pl0_parser_t<pl0_ast_term *> pl0_term;
+extern pl0_parser_t<pl0_ast_factor *> pl0_factor;
+extern pl0_parser_t<pl0_ast_call_func *> pl0_call_func;
+extern pl0_parser_t<pl0_ast_arg_list *> pl0_arg_list;
+extern pl0_parser_t<pl0_ast_arg *> pl0_arg;
+extern pl0_parser_t<pl0_ast_addop *> pl0_addop;
+extern pl0_parser_t<pl0_ast_multop *> pl0_multop;
+extern pl0_parser_t<pl0_ast_condtion *> pl0_condition;
+extern pl0_parser_t<pl0_ast_comp_op *> pl0_comp_op;
+extern pl0_parser_t<pl0_ast_cond_stmt *> pl0_cond_stmt;
+extern pl0_parser_t<pl0_ast_case_stmt *> pl0_case_stmt;
+extern pl0_parser_t<pl0_ast_case_term *> pl0_case_term;
+extern pl0_parser_t<pl0_ast_for_stmt *> pl0_for_stmt;
+extern pl0_parser_t<pl0_ast_call_proc *> pl0_call_proc;
+extern pl0_parser_t<pl0_ast_compound_stmt *> pl0_compound_stmt;
+extern pl0_parser_t<pl0_ast_read_stmt *> pl0_read_stmt;
+extern pl0_parser_t<pl0_ast_write_stmt *> pl0_write_stmt;
 extern parser_t<pl0_ast_alnum *> pl0_alpha;
 extern parser_t<pl0_ast_alnum *> pl0_digit;
 
@@ -66,54 +67,52 @@ void pl0_parser_error(pair<int, int> loc, string msg) {
     cout << loc.first << ":" << loc.second << " " << "ERRRO: " << msg << endl;
 }
 
-static function<string (vector<char>)> vec2str = [](const vector<char> & vec) {
-    string ans; for (char c: vec) { ans.push_back(c); } return ans;
-};
-static const auto spaces = (++space)/vec2str;
+static auto const slice2str = [](slice_t const & s) { return s.str(); };
+static auto const slice2char = [](slice_t const & s) { return s.empty() ? '\0' : s.ptr[0]; };
 
 static bool verbose = false;
 
-// porting the `character` and `string_literal` parser generator from libparsec, for reporting parse error.
-pair<int, char> pl0_character_helper(char const & ch, input_t *text) {
-    if (text->empty()) { return make_pair(-1, '\0'); }
-    char c = text->at(0);
-    if (ch != c) { pl0_parser_error(text->locate(), string("expected character ") + "'" + string(0, ch) + "'"); }
-    return make_pair(ch == c ? (1) : (-1), ch);
+// location of the current token (or character), stored in the nodes.
+template<typename S>
+static inline pl0_loc_t pl0_loc(S const & text) {
+    return (pl0_loc_t)text.position();
 }
-parser_t<char> pl0_character(char const & ch) {
-    auto fn = std::bind(character_helper, ch, std::placeholders::_1);
-    return parser_t<char>("character: " + string(1, ch), fn);
+
+// the grammar rules match tokens (see `pl0_lexer`): keywords are words with a given text, operators and
+// punctuations are symbols.
+token_parser pl0_keyword(string const & word) {
+    return token(pl0_lexer::WORD, word);
 }
-pair<int, string> pl0_string_literal_helper(const string & str, input_t *text) {
-    if (text->empty()) { return make_pair(-1, "\0"); }
-    string s = text->take(str.length());
-    if (str != s) { pl0_parser_error(text->locate(), string("expected literal string ") + "\"" + str + "\""); }
-    return make_pair(str == s ? str.length() : (-1), str);
+token_parser pl0_symbol(string const & symbol) {
+    return token(pl0_lexer::SYMBOL, symbol);
 }
-parser_t<string> pl0_string_literal(string const & str) {
-    auto fn = std::bind(string_literal_helper, str, std::placeholders::_1);
-    return parser_t<string>("string literal: " + str, fn);
+token_parser pl0_character(char const & ch) {
+    return pl0_symbol(string(1, ch));
 }
 
+// synchronization points of the error recovery: a statement or a declaration that fails after its cut point is
+// reported and skipped up to the next `;`, `end` or `begin`.
+static auto const pl0_sync = pl0_character(';') | pl0_keyword("end") | pl0_keyword("begin");
+
 // <程序> ::= <分程序>.
-pair<int, pl0_ast_program *> pl0_program_fn(input_t *text) {
-    auto parser = pl0_prog << pl0_character('.');
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_program *> pl0_program_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_prog << pl0_character('.');
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Program" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_program(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_program>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <分程序> ::= [<常量说明部分>][<变量说明部分>]{[<过程说明部分>]| [<函数说明部分>]}<复合语句>
-pair<int, pl0_ast_prog *> pl0_prog_fn(input_t *text) {
-    auto parser = ((~pl0_const_stmt) + (~pl0_var_stmt)) + (++pl0_executable + pl0_compound_stmt);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_prog *> pl0_prog_fn(pl0_input_t const & text) {
+    static auto const parser = ((~pl0_const_stmt) + (~pl0_var_stmt)) + (++pl0_executable + pl0_compound_stmt);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Prog" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_prog(
-        text->locate(), 
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_prog>(
+        pl0_loc(text), 
         std::get<1>(res).first.first,
         std::get<1>(res).first.second,
         std::get<1>(res).second.first,
@@ -122,70 +121,75 @@ pair<int, pl0_ast_prog *> pl0_prog_fn(input_t *text) {
 }
 
 // <数字> ::= 0|1|2|3 ... 8|9
-pair<int, pl0_ast_alnum *> pl0_digit_fn(input_t *text) {
+pair<int, pl0_ast_alnum *> pl0_digit_fn(input_t const & text) {
     auto res = digit(text);
     // if (verbose) {
     //     cout << "parsing: Digit" << endl;
     // }
-    return make_pair(std::get<0>(res), new pl0_ast_alnum(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_alnum>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <字母> ::= a|b|c|d ... x|y|z |A|B…|Z
-pair<int, pl0_ast_alnum *> pl0_alpha_fn(input_t *text) {
+pair<int, pl0_ast_alnum *> pl0_alpha_fn(input_t const & text) {
     auto res = alpha(text);
     // if (verbose) {
     //     cout << "parsing: Alpha" << endl;
     // }
-    return make_pair(std::get<0>(res), new pl0_ast_alnum(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_alnum>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <字符> ::= '<字母>' | '<数字>'
-pair<int, pl0_ast_constv *> pl0_char_fn(input_t *text) {
-    auto parser = pl0_character('\'') >> (pl0_digit | pl0_alpha) << pl0_character('\'');
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_constv *> pl0_char_fn(pl0_input_t const & text) {
+    static auto const parser = token(pl0_lexer::CHAR);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Char" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_constv(text->locate(), std::get<1>(res) ? std::get<1>(res)->val : 0, pl0_ast_constv::CHAR));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_constv>(pl0_loc(text), std::get<1>(res).ptr[1], pl0_ast_constv::CHAR));
 }
 
 // <字符串> ::= "{十进制编码为32,33,35-126的ASCII字符}"
-pair<int, pl0_ast_charseq *> pl0_charseq_fn(input_t *text) {
-    auto parser = pl0_character('"') >> (++(print-pl0_character('"'))) << pl0_character('"');
-    auto res = (spaces >> (parser / vec2str) << spaces)(text);
+pair<int, pl0_ast_charseq *> pl0_charseq_fn(pl0_input_t const & text) {
+    static auto const parser = token(pl0_lexer::STRING);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Charseq" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_charseq(text->locate(), std::get<1>(res)));
+    // without the quotes.
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_charseq>(pl0_loc(text),
+        string(std::get<1>(res).ptr + 1, std::get<1>(res).len - 2)));
 }
 
 // <无符号整数> ::= <数字>{<数字>}
-pair<int, pl0_ast_constv *> pl0_unsigned_fn(input_t *text) {
-    function<unsigned int (vector<pl0_ast_alnum *>)> fn = [](vector<pl0_ast_alnum *> vec) {
-        unsigned int ans = 0; for (auto k: vec) { ans = ans * 10 + (k ? k->val - '0' : 0); } return ans;
+pair<int, pl0_ast_constv *> pl0_unsigned_fn(pl0_input_t const & text) {
+    static auto const fn = [](slice_t const & digits) {
+        unsigned int ans = 0; for (size_t i = 0; i < digits.length(); ++i) { ans = ans * 10 + (digits.ptr[i] - '0'); } return ans;
     };
-    auto res = ((spaces >> (pl0_digit++) << spaces) / fn)(text);
+    static auto const parser = token(pl0_lexer::UNSIGNED) / fn;
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Unsigned" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_constv(text->locate(), std::get<1>(res), pl0_ast_constv::INT));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_constv>(pl0_loc(text), std::get<1>(res), pl0_ast_constv::INT));
 }
 
 // <常量> ::= [+|-]<无符号整数>|<字符>
-pair<int, pl0_ast_constv *> pl0_const_fn(input_t *text) {
-    auto res1 = (spaces >> (pl0_character('+') | pl0_character('-')) << spaces)(text);
+pair<int, pl0_ast_constv *> pl0_const_fn(pl0_input_t const & text) {
+    static auto const sign = (pl0_character('+') | pl0_character('-')) / slice2char;
+    static auto const parser = pl0_unsigned | pl0_char;
+    auto res1 = sign(text);
     pair<int, pl0_ast_constv *> ans;
-    if (std::get<0>(res1) != -1) {
+    if (std::get<0>(res1) >= 0) {
         int flag = std::get<1>(res1) == '+' ? (1) : (-1);
-        auto res2 = pl0_unsigned(text->drop(std::get<0>(res1)));
+        auto res2 = pl0_unsigned(text.drop(std::get<0>(res1)));
         ans = make_pair(
-            std::get<0>(res2) == -1 ? -1 : (std::get<0>(res1) + std::get<0>(res2)),
-            new pl0_ast_constv(text->locate(), std::get<1>(res2)->val * flag, pl0_ast_constv::INT)
+            std::get<0>(res2) < 0 ? std::get<0>(res2) : (std::get<0>(res1) + std::get<0>(res2)),
+            std::get<0>(res2) < 0 ? nullptr : pl0_arena.make<pl0_ast_constv>(pl0_loc(text), std::get<1>(res2)->val * flag, pl0_ast_constv::INT)
         );
     }
     else {
-        auto res = (pl0_unsigned | pl0_char)(text);
-        ans = make_pair(std::get<0>(res), new pl0_ast_constv(text->locate(), std::get<1>(res) ? std::get<1>(res)->val : 0, std::get<1>(res) ? std::get<1>(res)->dt : pl0_ast_constv::INT));
+        auto res = parser(text);
+        ans = make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_constv>(pl0_loc(text), std::get<1>(res)->val, std::get<1>(res)->dt));
     }
     if (verbose) {
         cout << "parsing: Constant" << endl;
@@ -194,21 +198,19 @@ pair<int, pl0_ast_constv *> pl0_const_fn(input_t *text) {
 }
 
 // <标识符> ::= <字母>{<字母>|<数字>}
-pair<int, pl0_ast_identify *> pl0_identify_fn(input_t *text) {
-    static std::array<string, 17> keywords = {{
+pair<int, pl0_ast_identify *> pl0_identify_fn(pl0_input_t const & text) {
+    static auto const reserved = keywords({
         "begin", "end", "for", "downto", "to", "do", "if", "then", "else", "case",
-        "const", "var", "array", "of", "case", "integer", "char"}};
-    function<string (pair<pl0_ast_alnum *, vector<pl0_ast_alnum *>>)> fn = [](pair<pl0_ast_alnum *, vector<pl0_ast_alnum *>> const & p) {
-        string ans = string(1, p.first ? p.first->val : 0); for (pl0_ast_alnum *c: p.second) { ans.push_back(c ? c->val : 0); } return ans;
-    };
-    auto parser = pl0_alpha + (++(pl0_alpha | pl0_digit));
-    auto res = (spaces >> (parser / fn) << spaces)(text);
+        "const", "var", "array", "of", "integer", "char", "procedure", "function"});
+    // a word that isn't a keyword.
+    static auto const parser = token(pl0_lexer::WORD);
+    auto res = parser(text);
     pair<int, pl0_ast_identify *> ans;
-    if (std::get<0>(res) != -1 && std::none_of(keywords.begin(), keywords.end(), [&, res](string s) { return s == std::get<1>(res); })) {
-        ans = make_pair(std::get<0>(res), new pl0_ast_identify(text->locate(), std::get<1>(res)));
+    if (std::get<0>(res) >= 0 && reserved.find(std::get<1>(res).ptr, std::get<1>(res).len) == -1) {
+        ans = make_pair(std::get<0>(res), pl0_arena.make<pl0_ast_identify>(pl0_loc(text), std::get<1>(res).str()));
     }
     else {
-        ans = make_pair(-1, new pl0_ast_identify(text->locate(), ""));
+        ans = make_pair(-1, nullptr);
     }
     if (verbose) {
         cout << "parsing: Identifier" << endl;
@@ -217,98 +219,116 @@ pair<int, pl0_ast_identify *> pl0_identify_fn(input_t *text) {
 }
 
 // <基本类型> ::= integer | char
-pair<int, pl0_ast_primitive_type *> pl0_primitive_type_fn(input_t *text) {
-    auto parser = pl0_string_literal("integer") | pl0_string_literal("char");
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_primitive_type *> pl0_primitive_type_fn(pl0_input_t const & text) {
+    static auto const integer = [](slice_t const &) { return pl0_type_t::INTEGER; };
+    static auto const character = [](slice_t const &) { return pl0_type_t::CHAR; };
+    static auto const parser = (pl0_keyword("integer") / integer) | (pl0_keyword("char") / character);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Primitive Type" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_primitive_type(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_primitive_type>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <类型> ::= <基本类型>|array'['<无符号整数>']' of <基本类型>
-pair<int, pl0_ast_type *> pl0_type_fn(input_t *text) {
-    function<pair<pl0_ast_constv *, pl0_ast_primitive_type *> (pl0_ast_primitive_type *)> fn = [&, text](pl0_ast_primitive_type *t) { return make_pair(new pl0_ast_constv(text->locate(), -1, pl0_ast_constv::INT), t); };
-    auto parser = (pl0_primitive_type / fn) // not array
-        | ((pl0_string_literal("array") >> spaces >> (pl0_character('[') >> pl0_unsigned << pl0_character(']')) << spaces << pl0_string_literal("of")) + pl0_primitive_type); // array
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_type *> pl0_type_fn(pl0_input_t const & text) {
+    // no array size: -1.
+    static auto const fn = [](pl0_ast_primitive_type *t) { return make_pair(static_cast<pl0_ast_constv *>(nullptr), t); };
+    static auto const array_type = pl0_keyword("array") >> commit(((pl0_character('[') >> pl0_unsigned << pl0_character(']')) << pl0_keyword("of")) + pl0_primitive_type);
+    static auto const parser = (pl0_primitive_type / fn) // not array
+        | array_type; // array
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Type" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_type(text->locate(), std::get<1>(res).second, std::get<1>(res).first ? std::get<1>(res).first->val : -1));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_type>(pl0_loc(text), std::get<1>(res).second, std::get<1>(res).first ? std::get<1>(res).first->val : -1));
 }
 
 // <加法运算符> ::= +|-
-pair<int, pl0_ast_addop *> pl0_addop_fn(input_t *text) {
-    auto res = (spaces >> (pl0_character('+') | pl0_character('-')) << spaces)(text);
+pair<int, pl0_ast_addop *> pl0_addop_fn(pl0_input_t const & text) {
+    static auto const parser = (pl0_character('+') | pl0_character('-')) / slice2char;
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Add/Minus" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_addop(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_addop>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <乘法运算符> ::= *|/ 扩展：添加 %
-pair<int, pl0_ast_multop *> pl0_multop_fn(input_t *text) {
-    auto res = (spaces >> (pl0_character('*') | pl0_character('/') | pl0_character('%')) << spaces)(text);
+pair<int, pl0_ast_multop *> pl0_multop_fn(pl0_input_t const & text) {
+    static auto const parser = (pl0_character('*') | pl0_character('/') | pl0_character('%')) / slice2char;
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Mult/Div/Mod" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_multop(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_multop>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <变量说明> ::= <标识符>{, <标识符>} : <类型>
-pair<int, pl0_ast_var_define *> pl0_var_define_fn(input_t *text) {
-    auto parser = (pl0_identify % pl0_character(',')) + (pl0_character(':') >> pl0_type);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_var_define *> pl0_var_define_fn(pl0_input_t const & text) {
+    // an identifier starts a variable definition, the declaration part ends at a keyword.
+    static auto const parser = pl0_identify + commit((++(pl0_character(',') >> pl0_identify)) + (pl0_character(':') >> pl0_type));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Variable Define" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_var_define(text->locate(), std::get<1>(res).second, std::get<1>(res).first));
+    if (std::get<0>(res) < 0) {
+        return make_pair(std::get<0>(res), nullptr);
+    }
+    std::vector<pl0_ast_identify *> ids;
+    ids.reserve(1 + std::get<1>(res).second.first.size());
+    ids.push_back(std::get<1>(res).first);
+    ids.insert(ids.end(), std::get<1>(res).second.first.begin(), std::get<1>(res).second.first.end());
+    return make_pair(std::get<0>(res), pl0_arena.make<pl0_ast_var_define>(pl0_loc(text), std::get<1>(res).second.second, ids));
 }
 
 // <变量说明部分> ::= var <变量说明> ; {<变量说明>;}
-pair<int, pl0_ast_var_stmt *> pl0_var_stmt_fn(input_t *text) {
-    auto parser = pl0_string_literal("var") >> ((pl0_var_define << pl0_character(';'))++);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_var_stmt *> pl0_var_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("var") >> commit((recover(pl0_var_define, pl0_sync, "invalid variable definition") << pl0_character(';'))++);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Variable Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_var_stmt(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_var_stmt>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <常量定义> ::= <标识符>＝ <常量>
-pair<int, pl0_ast_const_define *> pl0_const_define_fn(input_t *text) {
-    auto parser = pl0_identify + (pl0_character('=') >> pl0_const);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_const_define *> pl0_const_define_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_identify + commit(pl0_character('=') >> pl0_const);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Constant Define" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_const_define(text->locate(), std::get<1>(res).first, std::get<1>(res).second));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_const_define>(pl0_loc(text), std::get<1>(res).first, std::get<1>(res).second));
 }
 
 // <常量说明部分> ::= const<常量定义>{,<常量定义>};
-pair<int, pl0_ast_const_stmt *> pl0_const_stmt_fn(input_t *text) {
-    auto parser = pl0_string_literal("const") >> (pl0_const_define % pl0_character(',')) << pl0_character(';');
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_const_stmt *> pl0_const_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("const") >> commit((recover(pl0_const_define, pl0_sync, "invalid constant definition") % pl0_character(',')) << pl0_character(';'));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Constant Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_const_stmt(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_const_stmt>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <形式参数段> ::= [var]<标识符>{, <标识符>}: <基本类型>
-pair<int, pl0_ast_param_group *> pl0_param_group_fn(input_t *text) {
+pair<int, pl0_ast_param_group *> pl0_param_group_fn(pl0_input_t const & text) {
     // var declaration in parameter group indicates call-by-ref, else call-by-value.
-    int vardecl = std::get<0>((spaces >> pl0_string_literal("var") << spaces)(text));
-    auto parser = (pl0_identify % pl0_character(',')) + (pl0_character(':') >> pl0_primitive_type);
-    auto res = (spaces >> parser << spaces)(text->drop(vardecl == -1 ? 0: vardecl));
+    static auto const var = pl0_keyword("var");
+    static auto const parser = (pl0_identify % pl0_character(',')) + (pl0_character(':') >> pl0_primitive_type);
+    int vardecl = std::get<0>(var(text));
+    auto res = parser(text.drop(vardecl == -1 ? 0: vardecl));
     if (verbose) {
         cout << "parsing: Parameter Group" << endl;
     }
+    if (std::get<0>(res) < 0) {
+        return make_pair(std::get<0>(res), nullptr);
+    }
     return make_pair(
         (vardecl == -1 ? 0 : vardecl) + std::get<0>(res),
-        new pl0_ast_param_group(
-            text->locate(),
+        pl0_arena.make<pl0_ast_param_group>(
+            pl0_loc(text),
             std::get<1>(res).first,
             std::get<1>(res).second,
             vardecl != -1
@@ -317,73 +337,75 @@ pair<int, pl0_ast_param_group *> pl0_param_group_fn(input_t *text) {
 }
 
 // <形式参数表> ::= '(' <形式参数段>{; <形式参数段>}')'
-pair<int, pl0_ast_param_list *> pl0_param_list_fn(input_t *text) {
-    auto parser = pl0_character('(') >> (pl0_param_group % pl0_character(';')) << pl0_character(')');
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_param_list *> pl0_param_list_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_character('(') >> commit((pl0_param_group % pl0_character(';')) << pl0_character(')'));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Parameter List" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_param_list(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_param_list>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <函数标识符> ::= <标识符>
-pair<int, pl0_ast_function_id *> pl0_function_id_fn(input_t *text) {
+pair<int, pl0_ast_function_id *> pl0_function_id_fn(pl0_input_t const & text) {
     auto res = pl0_identify(text);
     if (verbose) {
         cout << "parsing: Function Identifier" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_function_id(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_function_id>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <过程首部> ::= procedure<标识符>[<形式参数表>];
-pair<int, pl0_ast_procedure_header *> pl0_procedure_header_fn(input_t *text) {
-    auto parser = pl0_string_literal("procedure") >> (pl0_identify + (~pl0_param_list)) << pl0_character(';');
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_procedure_header *> pl0_procedure_header_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("procedure") >> commit((pl0_identify + (~pl0_param_list)) << pl0_character(';'));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Procedure Header" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_procedure_header(text->locate(), std::get<1>(res).first, std::get<1>(res).second));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_procedure_header>(pl0_loc(text), std::get<1>(res).first, std::get<1>(res).second));
 }
 
 // <函数首部> ::= function <标识符>[<形式参数表>]: <基本类型>;
-pair<int, pl0_ast_function_header *> pl0_function_header_fn(input_t *text) {
-    auto parser = (pl0_string_literal("function") >> (pl0_identify + (~pl0_param_list))) + (pl0_character(':') >> pl0_primitive_type << pl0_character(';'));
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_function_header *> pl0_function_header_fn(pl0_input_t const & text) {
+    static auto const parser = (pl0_keyword("function") >> commit(pl0_identify + (~pl0_param_list))) + commit(pl0_character(':') >> pl0_primitive_type << pl0_character(';'));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Function Header" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_function_header(text->locate(), std::get<1>(res).first.first, std::get<1>(res).first.second, std::get<1>(res).second));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_function_header>(pl0_loc(text), std::get<1>(res).first.first, std::get<1>(res).first.second, std::get<1>(res).second));
 }
 
 // <过程说明部分> ::= <过程首部><分程序>{; <过程首部><分程序>};
-pair<int, pl0_ast_procedure_stmt *> pl0_procedure_stmt_fn(input_t *text) {
-    auto res = (((pl0_procedure_header + pl0_prog) << pl0_character(';'))++)(text);
+pair<int, pl0_ast_procedure_stmt *> pl0_procedure_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = ((pl0_procedure_header + pl0_prog) << pl0_character(';'))++;
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Procedure Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_procedure_stmt(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_procedure_stmt>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <函数说明部分> ::= <函数首部><分程序>{; <函数首部><分程序>};
-pair<int, pl0_ast_function_stmt *> pl0_function_stmt_fn(input_t *text) {
-    auto res = (((pl0_function_header + pl0_prog) << pl0_character(';'))++)(text);
+pair<int, pl0_ast_function_stmt *> pl0_function_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = ((pl0_function_header + pl0_prog) << pl0_character(';'))++;
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Function Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_function_stmt(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_function_stmt>(pl0_loc(text), std::get<1>(res)));
 }
 
 // 可调用对象 ::= <函数说明部分> | <过程说明部分>
-pair<int, pl0_ast_executable *> pl0_executable_fn(input_t *text) {
+pair<int, pl0_ast_executable *> pl0_executable_fn(pl0_input_t const & text) {
     auto res = pl0_function_header(text);
     pair<int, pl0_ast_executable *> ans;
-    if (std::get<0>(res) != -1) {
+    if (std::get<0>(res) >= 0 || std::get<0>(res) == committed_failure) { // a function, even if a wrong one.
         auto res1 = pl0_function_stmt(text);
-        ans = make_pair(std::get<0>(res1), new pl0_ast_executable(text->locate(), std::get<1>(res1)));
+        ans = make_pair(std::get<0>(res1), std::get<0>(res1) < 0 ? nullptr : pl0_arena.make<pl0_ast_executable>(pl0_loc(text), std::get<1>(res1)));
     }
     else {
         auto res2 = pl0_procedure_stmt(text);
-        ans = make_pair(std::get<0>(res2), new pl0_ast_executable(text->locate(), std::get<1>(res2)));
+        ans = make_pair(std::get<0>(res2), std::get<0>(res2) < 0 ? nullptr : pl0_arena.make<pl0_ast_executable>(pl0_loc(text), std::get<1>(res2)));
     }
     if (verbose) {
         cout << "parsing: Executable (Function and Procedure)" << endl;
@@ -392,22 +414,22 @@ pair<int, pl0_ast_executable *> pl0_executable_fn(input_t *text) {
 }
 
 // <空语句>
-pair<int, pl0_ast_null_stmt *> pl0_null_stmt_fn(input_t *text) {
+pair<int, pl0_ast_null_stmt *> pl0_null_stmt_fn(pl0_input_t const & text) {
     if (verbose) {
         cout << "parsing: Null Statement" << endl;
     }
-    return make_pair(0, new pl0_ast_null_stmt(text->locate()));
+    return make_pair(0, pl0_arena.make<pl0_ast_null_stmt>(pl0_loc(text)));
 }
 
 // <赋值语句> ::= <标识符> := <表达式>| <函数标识符> := <表达式> | <标识符>'['<表达式>']':= <表达式>
-pair<int, pl0_ast_assign_stmt *> pl0_assign_stmt_fn(input_t *text) {
-    auto parser = pl0_identify + (~(pl0_character('[') >> pl0_expression << pl0_character(']'))) + (spaces >> pl0_string_literal(":=") >> pl0_expression);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_assign_stmt *> pl0_assign_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_identify + (~(pl0_character('[') >> commit(pl0_expression << pl0_character(']')))) + (pl0_symbol(":=") >> commit(pl0_expression));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Assign Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_assign_stmt(
-        text->locate(),
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_assign_stmt>(
+        pl0_loc(text),
         std::get<1>(res).first.first,
         std::get<1>(res).first.second,
         std::get<1>(res).second
@@ -415,23 +437,25 @@ pair<int, pl0_ast_assign_stmt *> pl0_assign_stmt_fn(input_t *text) {
 }
 
 // <语句> ::= <赋值语句>|<条件语句>|<情况语句>|<过程调用语句>|<复合语句>|<读语句>|<写语句>|<for循环语句>|<空>
-pair<int, pl0_ast_stmt *> pl0_stmt_fn(input_t *text) {
-    pair<int, pl0_ast_stmt *> ans;
-    std::tuple<int, pl0_ast_stmt *, string> res;
-    // short-circuit evaluation
-    if (std::get<0>(res = pl0_write_stmt(text)) != -1
-            || std::get<0>(res = pl0_read_stmt(text)) != -1
-            || std::get<0>(res = pl0_assign_stmt(text)) != -1
-            || std::get<0>(res = pl0_cond_stmt(text)) != -1
-            || std::get<0>(res = pl0_case_stmt(text)) != -1
-            || std::get<0>(res = pl0_compound_stmt(text)) != -1
-            || std::get<0>(res = pl0_for_stmt(text)) != -1
-            || std::get<0>(res = pl0_call_proc(text)) != -1) {
-        ans = make_pair(std::get<0>(res), std::get<1>(res));
-    }
-    else {
+pair<int, pl0_ast_stmt *> pl0_stmt_fn(pl0_input_t const & text) {
+    // predict the statement from its first word: keyword statements, then the ones starting with an identifier.
+    static auto const parser = recover(dispatch<pl0_ast_stmt *>(charset_t(),
+        alt({"write"}, pl0_write_stmt),
+        alt({"read"}, pl0_read_stmt),
+        alt({"if"}, pl0_cond_stmt),
+        alt({"case"}, pl0_case_stmt),
+        alt({"begin"}, pl0_compound_stmt),
+        alt({"for"}, pl0_for_stmt),
+        alt(alpha_set, pl0_assign_stmt),
+        alt(alpha_set, pl0_call_proc)), pl0_sync, "invalid statement");
+    pair<int, pl0_ast_stmt *> ans = parser(text);
+    if (std::get<0>(ans) == -1) {
         // default: empty statement.
-        ans = make_pair(0, new pl0_ast_null_stmt(text->locate()));
+        ans = make_pair(0, pl0_arena.make<pl0_ast_null_stmt>(pl0_loc(text)));
+    }
+    else if (std::get<1>(ans) == nullptr) {
+        // an invalid statement has been reported and skipped.
+        ans = make_pair(std::get<0>(ans), pl0_arena.make<pl0_ast_null_stmt>(pl0_loc(text)));
     }
     if (verbose) {
         cout << "parsing: Statement" << endl;
@@ -439,27 +463,73 @@ pair<int, pl0_ast_stmt *> pl0_stmt_fn(input_t *text) {
     return ans;
 }
 
+// the operators of <表达式> and <项> (<加法运算符> and <乘法运算符>) with their location, and their precedence.
+struct pl0_arith_op {
+    char op;
+    pl0_loc_t loc;
+};
+pair<int, pl0_arith_op> pl0_arith_op_fn(pl0_input_t const & text) {
+    static auto const parser = (pl0_character('+') | pl0_character('-') | pl0_character('*') | pl0_character('/') | pl0_character('%')) / slice2char;
+    auto res = parser(text);
+    return make_pair(std::get<0>(res), pl0_arith_op{std::get<1>(res), pl0_loc(text)});
+}
+static op_table_t<char> const pl0_arith_levels({{'+', {1, false}}, {'-', {1, false}}, {'*', {2, false}}, {'/', {2, false}}, {'%', {2, false}}});
+op_level_t pl0_arith_level(pl0_arith_op const & op) {
+    return pl0_arith_levels(op.op);
+}
+op_level_t pl0_multop_level(pl0_arith_op const & op) {
+    return op.op == '+' || op.op == '-' ? op_level_t{0, false} : pl0_arith_levels(op.op);
+}
+
+// an operand of the precedence parser: a factor, or the term or expression it has been folded into. Operators
+// are appended to the term and expression nodes as soon as they are parsed.
+struct pl0_arith_operand {
+    pl0_ast_factor *factor;
+    pl0_ast_term *term;
+    pl0_ast_expression *expr;
+};
+pl0_arith_operand pl0_arith_operand_fn(pl0_ast_factor *factor) {
+    return pl0_arith_operand{factor, nullptr, nullptr};
+}
+pl0_ast_term *pl0_arith_term(pl0_arith_operand const & x) {
+    return x.term ? x.term : pl0_arena.make<pl0_ast_term>(x.factor->loc, std::vector<std::pair<pl0_ast_multop *, pl0_ast_factor *>>{make_pair(nullptr, x.factor)});
+}
+pl0_ast_expression *pl0_arith_expression(pl0_arith_operand const & x) {
+    if (x.expr) {
+        return x.expr;
+    }
+    pl0_ast_term *term = pl0_arith_term(x);
+    return pl0_arena.make<pl0_ast_expression>(term->loc, std::vector<std::pair<pl0_ast_addop *, pl0_ast_term *>>{make_pair(nullptr, term)});
+}
+// the right operand of a <乘法运算符> is always a factor (nothing binds tighter).
+pl0_arith_operand pl0_arith_fold(pl0_arith_operand const & lhs, pl0_arith_op const & op, pl0_arith_operand const & rhs) {
+    if (op.op == '+' || op.op == '-') {
+        pl0_ast_expression *expr = pl0_arith_expression(lhs);
+        expr->terms.emplace_back(pl0_arena.make<pl0_ast_addop>(op.loc, op.op), pl0_arith_term(rhs));
+        return pl0_arith_operand{nullptr, nullptr, expr};
+    }
+    pl0_ast_term *term = pl0_arith_term(lhs);
+    term->factors.emplace_back(pl0_arena.make<pl0_ast_multop>(op.loc, op.op), rhs.factor);
+    return pl0_arith_operand{nullptr, term, nullptr};
+}
+
 // <表达式> ::= [+|]<项>{<加法运算符><项>}
-pair<int, pl0_ast_expression *> pl0_expression_fn(input_t *text) {
-    auto res1 = ((~pl0_addop) + pl0_term)(text);
+pair<int, pl0_ast_expression *> pl0_expression_fn(pl0_input_t const & text) {
+    static auto const sign = ~pl0_addop;
+    static auto const parser = precedence(pl0_factor / &pl0_arith_operand_fn,
+        basic_parser_fn<pl0_arith_op, pl0_input_t, pl0_arith_op_fn>("pl0 addop or multop"), &pl0_arith_level, &pl0_arith_fold);
+    auto res1 = sign(text);
+    auto res2 = parser(text.drop(std::get<0>(res1)));
     pair<int, pl0_ast_expression *> ans;
-    if (std::get<0>(res1) == -1) {
-        auto vec = std::vector<std::pair<struct pl0_ast_addop *, struct pl0_ast_term *>>();
-        ans = make_pair(-1, new pl0_ast_expression(text->locate(), vec));
+    if (std::get<0>(res2) < 0) {
+        ans = make_pair(std::get<0>(res2), nullptr);
     }
     else {
-        std::pair<struct pl0_ast_addop *, struct pl0_ast_term *> head;
-        int headlen = std::get<0>(res1);
-        if (std::get<1>(res1).first == nullptr) {
-            head = make_pair(new pl0_ast_addop(text->locate(), '+'), std::get<1>(res1).second); // default: '+'
-        }
-        else {
-            head = std::get<1>(res1);
-        }
-        auto res2 = (++(pl0_addop + pl0_term))(text->drop(headlen));
-        auto vec = std::get<1>(res2);
-        vec.emplace(vec.begin(), head);
-        ans = make_pair(headlen + std::get<0>(res2), new pl0_ast_expression(text->locate(), vec));
+        pl0_ast_expression *expr = pl0_arith_expression(std::get<1>(res2));
+        expr->loc = pl0_loc(text);
+        // default: '+'
+        expr->terms[0].first = std::get<1>(res1) ? std::get<1>(res1) : pl0_arena.make<pl0_ast_addop>(pl0_loc(text), '+');
+        ans = make_pair(std::get<0>(res1) + std::get<0>(res2), expr);
     }
     if (verbose) {
         cout << "parsing: Expression" << endl;
@@ -468,72 +538,85 @@ pair<int, pl0_ast_expression *> pl0_expression_fn(input_t *text) {
 }
 
 // <实在参数> ::= <表达式>
-pair<int, pl0_ast_arg *> pl0_arg_fn(input_t *text) {
+pair<int, pl0_ast_arg *> pl0_arg_fn(pl0_input_t const & text) {
     auto res = pl0_expression(text);
     if (verbose) {
         cout << "parsing: Argument" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_arg(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_arg>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <实在参数表> ::= '('<实在参数> {, <实在参数>}')'
-pair<int, pl0_ast_arg_list *> pl0_arg_list_fn(input_t *text) {
-    auto res = (pl0_character('(') >> (pl0_arg % pl0_character(',')) << pl0_character(')'))(text);
+pair<int, pl0_ast_arg_list *> pl0_arg_list_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_character('(') >> commit((pl0_arg % pl0_character(',')) << pl0_character(')'));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Argument List" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_arg_list(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_arg_list>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <函数调用语句> ::= <标识符>[<实在参数表>]
-pair<int, pl0_ast_call_func *> pl0_call_func_fn(input_t *text) {
-    auto parser = pl0_identify + (~pl0_arg_list);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_call_func *> pl0_call_func_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_identify + (~pl0_arg_list);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Function Call" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_call_func(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_call_func>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <项> ::= <因子>{<乘法运算符><因子>}
-pair<int, pl0_ast_term *> pl0_term_fn(input_t *text) {
-    auto parser = pl0_factor >= pl0_multop;
+pair<int, pl0_ast_term *> pl0_term_fn(pl0_input_t const & text) {
+    static auto const parser = precedence(pl0_factor / &pl0_arith_operand_fn,
+        basic_parser_fn<pl0_arith_op, pl0_input_t, pl0_arith_op_fn>("pl0 multop"), &pl0_multop_level, &pl0_arith_fold);
     auto res = parser(text);
     if (verbose) {
         cout << "parsing: Term" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_term(text->locate(), std::get<1>(res)));
+    if (std::get<0>(res) < 0) {
+        return make_pair(std::get<0>(res), nullptr);
+    }
+    pl0_ast_term *term = pl0_arith_term(std::get<1>(res));
+    term->loc = pl0_loc(text);
+    return make_pair(std::get<0>(res), term);
+}
+
+// the alternatives of <因子>, each one builds the factor node at the position of the factor.
+// (no cut after the '[' of an array element: a bad index falls back to the plain identifier, as before.)
+pair<int, pl0_ast_factor *> pl0_factor_array_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_identify + (pl0_character('[') >> pl0_expression << pl0_character(']'));
+    auto res = parser(text);
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_factor>(pl0_loc(text), std::get<1>(res)));
+}
+pair<int, pl0_ast_factor *> pl0_factor_expr_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_character('(') >> commit(pl0_expression << pl0_character(')'));
+    auto res = parser(text);
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_factor>(pl0_loc(text), pl0_ast_factor::type_t::EXPR, std::get<1>(res)));
+}
+pair<int, pl0_ast_factor *> pl0_factor_unsigned_fn(pl0_input_t const & text) {
+    auto res = pl0_unsigned(text);
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_factor>(pl0_loc(text), pl0_ast_factor::type_t::UNSIGNED, std::get<1>(res)));
+}
+pair<int, pl0_ast_factor *> pl0_factor_call_func_fn(pl0_input_t const & text) {
+    auto res = pl0_call_func(text);
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_factor>(pl0_loc(text), pl0_ast_factor::type_t::CALL_FUNC, std::get<1>(res)));
+}
+pair<int, pl0_ast_factor *> pl0_factor_identify_fn(pl0_input_t const & text) {
+    auto res = pl0_identify(text);
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_factor>(pl0_loc(text), pl0_ast_factor::type_t::ID, std::get<1>(res)));
 }
 
 // <因子> ::= <标识符> | <无符号整数> |'('<表达式>')' | <函数调用语句> | <标识符>'['<表达式>']'
-pair<int, pl0_ast_factor *> pl0_factor_fn(input_t *text) {
-    auto res1 = (pl0_identify + (pl0_character('[') >> pl0_expression << pl0_character(']') << spaces))(text);
-    pair<int, pl0_ast_factor *> ans;
-    if (std::get<0>(res1) != -1) {
-        ans = make_pair(std::get<0>(res1), new pl0_ast_factor(text->locate(), std::get<1>(res1)));
-    }
-    else {
-        auto res2 = (spaces >> pl0_character('(') >> (spaces >> pl0_expression << spaces) << pl0_character(')') << spaces)(text);
-        if (std::get<0>(res2) != -1) {
-            ans = make_pair(std::get<0>(res2), new pl0_ast_factor(text->locate(), pl0_ast_factor::type_t::EXPR, std::get<1>(res2)));
-        }
-        else {
-            auto res3 = (spaces >> pl0_unsigned << spaces)(text);
-            if (std::get<0>(res3) != -1) {
-                ans = make_pair(std::get<0>(res3), new pl0_ast_factor(text->locate(), pl0_ast_factor::type_t::UNSIGNED, std::get<1>(res3)));
-            }
-            else {
-                auto res4 = (spaces >> pl0_call_func << spaces)(text);
-                if (std::get<0>(res4) != -1) {
-                    ans = make_pair(std::get<0>(res4), new pl0_ast_factor(text->locate(), pl0_ast_factor::type_t::CALL_FUNC, std::get<1>(res4)));
-                }
-                else {
-                    auto res5 = (spaces >> pl0_identify << spaces)(text);
-                    ans = make_pair(std::get<0>(res5), new pl0_ast_factor(text->locate(), pl0_ast_factor::type_t::ID, std::get<1>(res5)));
-                }
-            }
-        }
-    }
+pair<int, pl0_ast_factor *> pl0_factor_fn(pl0_input_t const & text) {
+    // predict the factor from its first character.
+    static auto const parser = dispatch<pl0_ast_factor *>(charset_t(),
+        alt(alpha_set, basic_parser_fn<pl0_ast_factor *, pl0_input_t, pl0_factor_array_fn>("pl0 factor: array element")),
+        alt(charset_t::of("("), basic_parser_fn<pl0_ast_factor *, pl0_input_t, pl0_factor_expr_fn>("pl0 factor: expression")),
+        alt(digit_set, basic_parser_fn<pl0_ast_factor *, pl0_input_t, pl0_factor_unsigned_fn>("pl0 factor: unsigned")),
+        alt(alpha_set, basic_parser_fn<pl0_ast_factor *, pl0_input_t, pl0_factor_call_func_fn>("pl0 factor: call func")),
+        alt(alpha_set, basic_parser_fn<pl0_ast_factor *, pl0_input_t, pl0_factor_identify_fn>("pl0 factor: identify")));
+    auto ans = parser(text);
     if (verbose) {
         cout << "parsing: Factor" << endl;
     }
@@ -541,28 +624,35 @@ pair<int, pl0_ast_factor *> pl0_factor_fn(input_t *text) {
 }
 
 // <关系运算符> ::= <|<=|>|>= |=|<>
-pair<int, pl0_ast_comp_op *> pl0_comp_op_fn(input_t *text) {
-    auto parser = pl0_string_literal("<=")
-        | pl0_string_literal("<>")
-        | pl0_string_literal(">=")
-        | pl0_string_literal("<")
-        | pl0_string_literal(">")
-        | pl0_string_literal("=");
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_comp_op *> pl0_comp_op_fn(pl0_input_t const & text) {
+    static auto const ops = keywords({"<", "<=", ">", ">=", "=", "<>"});
+    // a symbol that is a relational operator, looked up in the trie at once.
+    static auto const parser = token(pl0_lexer::SYMBOL);
+    auto res = parser(text);
+    pair<int, pl0_ast_comp_op *> ans;
+    int op = std::get<0>(res) < 0 ? -1 : ops.find(std::get<1>(res).ptr, std::get<1>(res).len);
+    if (op != -1) {
+        // the words are in the order of `pl0_ast_comp_op::op_t`.
+        ans = make_pair(std::get<0>(res), pl0_arena.make<pl0_ast_comp_op>(pl0_loc(text), static_cast<pl0_ast_comp_op::op_t>(op)));
+    }
+    else {
+        ans = make_pair(-1, nullptr);
+    }
     if (verbose) {
         cout << "parsing: Compare Operator(LE, NE, GE, LT, GT, EQ)" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_comp_op(text->locate(), std::get<1>(res)));
+    return ans;
 }
 
 // <条件> ::= <表达式><关系运算符><表达式>
-pair<int, pl0_ast_condtion *> pl0_condition_fn(input_t *text) {
-    auto res = (spaces >> (pl0_expression + pl0_comp_op + pl0_expression) << spaces)(text);
+pair<int, pl0_ast_condtion *> pl0_condition_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_expression + pl0_comp_op + pl0_expression;
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Condition Expression" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_condtion(
-        text->locate(),
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_condtion>(
+        pl0_loc(text),
         std::get<1>(res).first.first,
         std::get<1>(res).first.second,
         std::get<1>(res).second
@@ -570,16 +660,16 @@ pair<int, pl0_ast_condtion *> pl0_condition_fn(input_t *text) {
 }
 
 // <条件语句> ::= if<条件>then<语句> | if<条件>then<语句>else<语句>
-pair<int, pl0_ast_cond_stmt *> pl0_cond_stmt_fn(input_t *text) {
-    auto parser = ((spaces >> pl0_string_literal("if") << spaces) >> pl0_condition)
-        + ((spaces >> pl0_string_literal("then") << spaces) >> pl0_stmt)
-        + ~((spaces >> pl0_string_literal("else") << spaces) >> pl0_stmt);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_cond_stmt *> pl0_cond_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("if") >> commit((pl0_condition
+        + (pl0_keyword("then") >> pl0_stmt))
+        + ~(pl0_keyword("else") >> pl0_stmt));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Condition Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_cond_stmt(
-        text->locate(),
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_cond_stmt>(
+        pl0_loc(text),
         std::get<1>(res).first.first,
         std::get<1>(res).first.second,
         std::get<1>(res).second
@@ -587,97 +677,104 @@ pair<int, pl0_ast_cond_stmt *> pl0_cond_stmt_fn(input_t *text) {
 }
 
 // <情况语句> ::= case <表达式> of <情况表元素>{; <情况表元素>} end
-pair<int, pl0_ast_case_stmt *> pl0_case_stmt_fn(input_t *text) {
-    auto parser = ((spaces >> pl0_string_literal("case") << spaces) >> (spaces >> pl0_expression << spaces) << pl0_string_literal("of"))
-        + ((pl0_case_term % pl0_character(';')) << (spaces >> pl0_string_literal("end") << spaces));
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_case_stmt *> pl0_case_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("case") >> commit((pl0_expression << pl0_keyword("of"))
+        + ((pl0_case_term % pl0_character(';')) << pl0_keyword("end")));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Case Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_case_stmt(text->locate(), std::get<1>(res).first, std::get<1>(res).second));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_case_stmt>(pl0_loc(text), std::get<1>(res).first, std::get<1>(res).second));
 }
 
 // <情况表元素> ::= <常量> : <语句>
-pair<int, pl0_ast_case_term *> pl0_case_term_fn(input_t *text) {
-    auto res = ((pl0_const << (spaces >> pl0_character(':') << spaces)) + pl0_stmt)(text);
-    if (std::get<0>(res) == -1) {
+pair<int, pl0_ast_case_term *> pl0_case_term_fn(pl0_input_t const & text) {
+    static auto const parser = (pl0_const << pl0_character(':')) + pl0_stmt;
+    auto res = parser(text);
+    if (std::get<0>(res) < 0) {
         cout << "REPORT" << endl;
     }
     if (verbose) {
         cout << "parsing: Cast Item" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_case_term(text->locate(), std::get<1>(res).first, std::get<1>(res).second));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_case_term>(pl0_loc(text), std::get<1>(res).first, std::get<1>(res).second));
 }
 
 // <for循环语句> ::= for <标识符> := <表达式> (downto | to) <表达式> do <语句> // 步长为1
-pair<int, pl0_ast_for_stmt *> pl0_for_stmt_fn(input_t *text) {
-    auto parser = (((spaces >> pl0_string_literal("for") << spaces) >> pl0_identify) + ((spaces >> pl0_string_literal(":=") << spaces) >> pl0_expression))
-        + (spaces >> (pl0_string_literal("downto") | pl0_string_literal("to")) << spaces)
-        + (pl0_expression + (pl0_string_literal("do") >> pl0_stmt));
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_for_stmt *> pl0_for_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("for") >> commit(((pl0_identify + (pl0_symbol(":=") >> pl0_expression))
+        + (pl0_keyword("downto") | pl0_keyword("to")))
+        + (pl0_expression + (pl0_keyword("do") >> pl0_stmt)));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: For Loop Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_for_stmt(
-        text->locate(),
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_for_stmt>(
+        pl0_loc(text),
         std::get<1>(res).first.first.first,
         std::get<1>(res).first.first.second,
         std::get<1>(res).second.first,
         std::get<1>(res).second.second,
-        std::get<1>(res).first.second == "downto" ? new pl0_ast_constv(text->locate(), -1, pl0_ast_constv::INT) : new pl0_ast_constv(text->locate(), 1, pl0_ast_constv::INT)
+        std::get<1>(res).first.second == "downto" ? pl0_arena.make<pl0_ast_constv>(pl0_loc(text), -1, pl0_ast_constv::INT) : pl0_arena.make<pl0_ast_constv>(pl0_loc(text), 1, pl0_ast_constv::INT)
     ));
 }
 
 // <过程调用语句> ::= <标识符>[<实在参数表>]
-pair<int, pl0_ast_call_proc *> pl0_call_proc_fn(input_t *text) {
-    auto parser = pl0_identify + (~pl0_arg_list);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_call_proc *> pl0_call_proc_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_identify + (~pl0_arg_list);
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Procedure Call" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_call_proc(text->locate(), std::get<1>(res).first, std::get<1>(res).second));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_call_proc>(pl0_loc(text), std::get<1>(res).first, std::get<1>(res).second));
 }
 
 // <复合语句> ::= begin<语句>{; <语句>}end
-pair<int, pl0_ast_compound_stmt *> pl0_compound_stmt_fn(input_t *text) {
-    auto parser = (spaces >> pl0_string_literal("begin") << spaces)
-        >> (pl0_stmt % (spaces >> pl0_character(';') << spaces))
-        << (spaces >> pl0_string_literal("end") << spaces);
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_compound_stmt *> pl0_compound_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("begin") >> commit((pl0_stmt % pl0_character(';')) << pl0_keyword("end"));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Compound Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_compound_stmt(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_compound_stmt>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <读语句> ::= read'('<标识符>{,<标识符>}')'
-pair<int, pl0_ast_read_stmt *> pl0_read_stmt_fn(input_t *text) {
-    auto parser = (spaces >> pl0_string_literal("read")) >> spaces >> pl0_character('(') >> (pl0_identify % pl0_character(',')) << pl0_character(')');
-    auto res = (spaces >> parser << spaces)(text);
+pair<int, pl0_ast_read_stmt *> pl0_read_stmt_fn(pl0_input_t const & text) {
+    static auto const parser = pl0_keyword("read") >> pl0_character('(') >> commit((pl0_identify % pl0_character(',')) << pl0_character(')'));
+    auto res = parser(text);
     if (verbose) {
         cout << "parsing: Read Statement" << endl;
     }
-    return make_pair(std::get<0>(res), new pl0_ast_read_stmt(text->locate(), std::get<1>(res)));
+    return make_pair(std::get<0>(res), std::get<0>(res) < 0 ? nullptr : pl0_arena.make<pl0_ast_read_stmt>(pl0_loc(text), std::get<1>(res)));
 }
 
 // <写语句> ::= write '(' <字符串>,<表达式> ')'|write'(' <字符串> ')'|write'('<表达式>')'
-pair<int, pl0_ast_write_stmt *> pl0_write_stmt_fn(input_t *text) {
+pair<int, pl0_ast_write_stmt *> pl0_write_stmt_fn(pl0_input_t const & text) {
+    // the string, if any, decides the form of the statement after `write (`.
+    static auto const head = pl0_keyword("write") >> pl0_character('(');
+    static auto const string_args = pl0_charseq + commit((~(pl0_character(',') >> pl0_expression)) << pl0_character(')'));
+    static auto const expr_args = commit(pl0_expression << pl0_character(')'));
     pair<int, pl0_ast_write_stmt *> ans;
-    auto parser1 = pl0_charseq + (pl0_character(',') >> pl0_expression);
-    auto parser2 = pl0_charseq;
-    auto parser3 = pl0_expression;
-    auto res1 = (spaces >> (pl0_string_literal("write") >> spaces >> pl0_character('(') >> parser1 << pl0_character(')')) << spaces)(text);
-    if (std::get<0>(res1) != -1) {
-        ans = make_pair(std::get<0>(res1), new pl0_ast_write_stmt(text->locate(), std::get<1>(res1).first, std::get<1>(res1).second));
+    auto res1 = head(text);
+    if (std::get<0>(res1) < 0) {
+        ans = make_pair(std::get<0>(res1), nullptr);
     }
     else {
-        auto res2 = (spaces >> (pl0_string_literal("write") >> spaces >> pl0_character('(') >> parser2 << pl0_character(')')) << spaces)(text);
-        if (std::get<0>(res2) != -1) {
-            ans = make_pair(std::get<0>(res2), new pl0_ast_write_stmt(text->locate(), std::get<1>(res2)));
+        auto res2 = string_args(text.drop(std::get<0>(res1)));
+        if (std::get<0>(res2) >= 0) {
+            pl0_ast_write_stmt *stmt = std::get<1>(res2).second == nullptr
+                ? pl0_arena.make<pl0_ast_write_stmt>(pl0_loc(text), std::get<1>(res2).first)
+                : pl0_arena.make<pl0_ast_write_stmt>(pl0_loc(text), std::get<1>(res2).first, std::get<1>(res2).second);
+            ans = make_pair(std::get<0>(res1) + std::get<0>(res2), stmt);
+        }
+        else if (std::get<0>(res2) == committed_failure) {
+            ans = make_pair(committed_failure, nullptr);
         }
         else {
-            auto res3 = (spaces >> (pl0_string_literal("write") >> spaces >> pl0_character('(') >> parser3 << pl0_character(')')) << spaces)(text);
-            ans = make_pair(std::get<0>(res3), new pl0_ast_write_stmt(text->locate(), std::get<1>(res3)));
+            auto res3 = expr_args(text.drop(std::get<0>(res1)));
+            ans = make_pair(std::get<0>(res3) < 0 ? std::get<0>(res3) : std::get<0>(res1) + std::get<0>(res3),
+                std::get<0>(res3) < 0 ? nullptr : pl0_arena.make<pl0_ast_write_stmt>(pl0_loc(text), std::get<1>(res3)));
         }
     }
     if (verbose) {
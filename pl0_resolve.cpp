@@ -0,0 +1,380 @@
+/**
+ * Name resolution: binds every identifier of the tree to its declaration, following the scoping rules of PL0,
+ * and reports redefined and undeclared identifiers. The TAC generator reads the bindings and never looks a
+ * name up.
+ *
+ * The frames are laid out here as well: every variable, parameter and return value gets its slot, so the code
+ * generator addresses them by the slots on the operands.
+ */
+
+#include <string>
+#include <vector>
+#include "pl0_ast.hpp"
+
+void pl0_ast_error(pl0_loc_t loc, string msg);
+
+void pl0_resolve_program(pl0_ast_program const *program);
+static void pl0_resolve_prog(pl0_ast_prog const *prog);
+static void pl0_resolve_const_stmt(pl0_ast_const_stmt const *stmts);
+static void pl0_resolve_var_stmt(pl0_ast_var_stmt const *stmts);
+static void pl0_resolve_procedure_stmt(pl0_ast_procedure_stmt const *stmts);
+static void pl0_resolve_function_stmt(pl0_ast_function_stmt const *stmts);
+static vector<pl0_type_t> pl0_resolve_param(pl0_ast_param_list const *param);
+static void pl0_resolve_stmt(pl0_ast_stmt const *stmt);
+static void pl0_resolve_expr(pl0_ast_expression const *expr);
+static void pl0_resolve_factor(pl0_ast_factor const *factor);
+static void pl0_resolve_call_func(pl0_ast_call_func const *stmt);
+
+// an entry of the scopes: the name, the declaration and where it lives.
+template<typename T>
+struct pl0_decl {
+    pl0_sym_t name;
+    T const *entry;
+    pl0_slot_t slot;
+    pl0_decl(): name(), entry(nullptr) {}
+    pl0_decl(T const *entry, pl0_slot_t slot): name(entry->name), entry(entry), slot(slot) {}
+    std::string str() const { return entry->str(); }
+};
+
+static std::vector<pl0_sym_t> scope;
+static pl0_sym_t scope_name() {
+    string name = "";
+    for (auto && s: scope) {
+        name = name + "_" + s.str();
+    }
+    return pl0_symbols.intern(name);
+}
+static pl0_env<pl0_decl<constant>> valtb;
+static pl0_env<pl0_decl<variable>> vartb;
+static pl0_env<pl0_decl<proc>> proctb;
+static pl0_env<pl0_decl<func>> functb;
+
+// the frame being laid out: its static depth and the lowest offset taken. The locals grow downwards from the
+// base pointer, below the displays of the enclosing frames and the saved base pointer (4 bytes each), and the
+// parameters are above the return address, the first one at +8.
+static int frame_depth = 0, frame_top = 0;
+static void pl0_frame(int depth) {
+    frame_depth = depth; frame_top = -4 * depth;
+}
+static pl0_slot_t pl0_frame_alloc(int size) {
+    frame_top -= size;
+    return pl0_slot_t(frame_depth, frame_top);
+}
+
+static void pl0_bind(pl0_ast_identify *id, pl0_slot_t slot, constant const *val) {
+    id->binding.kind = pl0_ast_binding::CONSTANT; id->binding.slot = slot; id->binding.val = val;
+}
+static void pl0_bind(pl0_ast_identify *id, pl0_slot_t slot, variable const *var) {
+    id->binding.kind = pl0_ast_binding::VARIABLE; id->binding.slot = slot; id->binding.var = var;
+}
+static void pl0_bind(pl0_ast_identify *id, pl0_slot_t slot, proc const *p) {
+    id->binding.kind = pl0_ast_binding::PROCEDURE; id->binding.slot = slot; id->binding.proc = p;
+}
+static void pl0_bind(pl0_ast_identify *id, pl0_slot_t slot, func const *f) {
+    id->binding.kind = pl0_ast_binding::FUNCTION; id->binding.slot = slot; id->binding.func = f;
+}
+
+// bind `id` to the newest declaration of its name in `env`, false if there's none.
+template<typename T>
+static bool pl0_bind(pl0_env<pl0_decl<T>> & env, pl0_ast_identify *id) {
+    pl0_decl<T> decl;
+    if (!env.find(id->id, true, decl)) {
+        return false;
+    }
+    pl0_bind(id, decl.slot, decl.entry);
+    return true;
+}
+
+void pl0_resolve_program(pl0_ast_program const *program) {
+    pl0_frame(1);
+    pl0_resolve_prog(program->program);
+}
+
+static void pl0_resolve_prog(pl0_ast_prog const *prog) {
+    // set up new flag.
+    valtb.tag(); vartb.tag();
+    proctb.tag(); functb.tag();
+    pl0_resolve_const_stmt(prog->consts);
+    pl0_resolve_var_stmt(prog->vars);
+    for (auto && e: prog->exes) {
+        switch (e->t) {
+            case pl0_ast_executable::type_t::PROCEDURE:
+                pl0_resolve_procedure_stmt(e->proc); break;
+            case pl0_ast_executable::type_t::FUNCTION:
+                pl0_resolve_function_stmt(e->func); break;
+            default: cout << "ERROR" << endl;
+        }
+    }
+    pl0_resolve_stmt(prog->stmts);
+    // pop stack.
+    valtb.detag(); vartb.detag();
+    proctb.detag(), functb.detag();
+}
+
+static void pl0_resolve_const_stmt(pl0_ast_const_stmt const *stmts) {
+    if (!stmts) { return; }
+    for (auto && def: stmts->stmt) {
+        pl0_sym_t id = def->id->id;
+        // validate.
+        if (!scope.empty() && id == scope.back()) {
+            pl0_ast_error(def->id->loc, string("duplicate identifier ") + "\"" + id.str() + "\"");
+        }
+        else if (valtb.find(id, false) || vartb.find(id, false)) {
+            pl0_ast_error(def->id->loc, string("redefinition of ") + "\"" + id.str() + "\"");
+        }
+        else {
+            constant *val = pl0_arena.make<constant>(id, def->val->val, (def->val->dt == pl0_ast_constv::INT ? pl0_type_t::INTEGER : pl0_type_t::CHAR));
+            valtb.push(pl0_decl<constant>(val, pl0_slot_t(frame_depth))); // update symbol table.
+            pl0_bind(def->id, pl0_slot_t(frame_depth), val);
+        }
+    }
+}
+
+static void pl0_resolve_var_stmt(pl0_ast_var_stmt const *stmts) {
+    if (!stmts) { return; }
+    for (auto && s: stmts->stmt) {
+        for (auto && id: s->ids) {
+            // validate.
+            if (!scope.empty() && id->id == scope.back()) {
+                pl0_ast_error(id->loc, string("duplicate identifier ") + "\"" + id->id.str() + "\"");
+            }
+            else if (valtb.find(id->id, false) || vartb.find(id->id, false)) {
+                pl0_ast_error(id->loc, string("redefinition of ") + "\"" + id->id.str() + "\"");
+            }
+            else {
+                pl0_type_t t(s->type->type->dt.kind, s->type->len);
+                variable *var = pl0_arena.make<variable>(id->id, s->type->type->dt, t, s->type->len);
+                pl0_slot_t slot = pl0_frame_alloc(s->type->len == -1 ? 4 : 4 * s->type->len);
+                vartb.push(pl0_decl<variable>(var, slot)); // update symbol table.
+                pl0_bind(id, slot, var);
+            }
+        }
+    }
+}
+
+static void pl0_resolve_procedure_stmt(pl0_ast_procedure_stmt const *stmts) {
+    for (auto && p: stmts->procs) {
+        // validate.
+        pl0_sym_t pid = p.first->id->id;
+        if (valtb.find(pid, false) || vartb.find(pid, false) || proctb.find(pid, false) || functb.find(pid, false)
+                || (!scope.empty() && pid == scope.back())) {
+            pl0_ast_error(p.first->id->loc, string("overloaded identifier ") + "\"" + pid.str() + "\"" + " isn't a function");
+        }
+        else {
+            int depth = frame_depth, top = frame_top;
+            scope.emplace_back(pid); // update global scope.
+            pl0_frame((int)scope.size() + 1);
+            vector<pl0_type_t> proctype = pl0_resolve_param(p.first->params);
+            proc *e = pl0_arena.make<proc>(scope_name(), proctype);
+            proctb.push(pl0_decl<proc>(e, pl0_slot_t(depth))); // update symbol table.
+            pl0_bind(p.first->id, pl0_slot_t(depth), e);
+            proctb.tag(); functb.tag();
+            pl0_resolve_prog(p.second);
+            // end of current scope.
+            scope.pop_back(); // restore scope.
+            frame_depth = depth; frame_top = top;
+            valtb.detag(); vartb.detag();
+            proctb.detag(), functb.detag();
+        }
+    }
+}
+
+static void pl0_resolve_function_stmt(pl0_ast_function_stmt const *stmts) {
+    for (auto && f: stmts->funcs) {
+        // validate.
+        pl0_sym_t fid = f.first->id->id;
+        if (valtb.find(fid, false) || vartb.find(fid, false) || proctb.find(fid, false) || functb.find(fid, false)
+                || (!scope.empty() && fid == scope.back())) {
+            pl0_ast_error(f.first->id->loc, string("overloaded identifier ") + "\"" + fid.str() + "\"" + " isn't a function");
+        }
+        else {
+            int depth = frame_depth, top = frame_top;
+            scope.emplace_back(fid); // update global scope.
+            pl0_frame((int)scope.size() + 1);
+            vector<pl0_type_t> functype = pl0_resolve_param(f.first->params);
+            func *e = pl0_arena.make<func>(scope_name(), f.first->type->dt, functype);
+            pl0_slot_t retval = pl0_frame_alloc(4); // the return value comes first in the frame.
+            functb.push(pl0_decl<func>(e, retval)); // update symbol table
+            pl0_bind(f.first->id, retval, e);
+            proctb.tag(); functb.tag();
+            pl0_resolve_prog(f.second);
+            // end of current scope.
+            scope.pop_back(); // restore scope.
+            frame_depth = depth; frame_top = top;
+            valtb.detag(); vartb.detag();
+            proctb.detag(), functb.detag();
+        }
+    }
+}
+
+static vector<pl0_type_t> pl0_resolve_param(pl0_ast_param_list const *param) {
+    // set up new flag, new scope.
+    valtb.tag(); vartb.tag();
+
+    if (!param) { return vector<pl0_type_t>(); } // no parameter.
+    vector<pl0_type_t> type;
+    int offset = 8; // above the saved base pointer and the return address.
+    for (auto && group: param->params) {
+        for (auto && id: group->ids) {
+            // validte.
+            if (vartb.find(id->id, false) || id->id == scope.back()) {
+                pl0_ast_error(id->loc, string("duplicate parameter ") + id->id.str());
+            }
+            variable *var = pl0_arena.make<variable>(id->id, group->type->dt, group->type->dt);
+            pl0_slot_t slot(frame_depth, offset, group->is_ref);
+            vartb.push(pl0_decl<variable>(var, slot)); // add parameters to symbol table.
+            pl0_bind(id, slot, var);
+            offset += 4;
+            type.emplace_back(group->is_ref ? group->type->dt.byref() : group->type->dt);
+        }
+    }
+    return type;
+}
+
+static void pl0_resolve_stmt(pl0_ast_stmt const *stmt) {
+    if (stmt == nullptr) { return; } // check if null pointer.
+    switch (stmt->t) {
+        case pl0_ast_stmt::type_t::ASSIGN_STMT: {
+            auto s = dynamic_cast<pl0_ast_assign_stmt const *>(stmt);
+            pl0_resolve_expr(s->val);
+            if (s->idx == nullptr && functb.depth(s->id->id) > vartb.depth(s->id->id)) {
+                pl0_bind(functb, s->id); // set function's retval.
+            }
+            else {
+                if (s->id->id.str().front() == '^') {
+                    pl0_ast_error(s->id->loc, string("illegal assign to loop variable"));
+                }
+                if (!pl0_bind(vartb, s->id)) {
+                    pl0_ast_error(s->id->loc, string("use of undeclared identifier ") + "\"" + s->id->id.str() + "\"");
+                }
+                if (s->idx) {
+                    pl0_resolve_expr(s->idx);
+                }
+            }
+            break;
+        }
+        case pl0_ast_stmt::type_t::COND_STMT: {
+            auto s = dynamic_cast<pl0_ast_cond_stmt const *>(stmt);
+            pl0_resolve_expr(s->cond->lhs);
+            pl0_resolve_expr(s->cond->rhs);
+            pl0_resolve_stmt(s->then_block);
+            pl0_resolve_stmt(s->else_block);
+            break;
+        }
+        case pl0_ast_stmt::type_t::CASE_STMT: {
+            auto s = dynamic_cast<pl0_ast_case_stmt const *>(stmt);
+            pl0_resolve_expr(s->expr);
+            for (auto && term: s->terms) {
+                pl0_resolve_stmt(term->stmt);
+            }
+            break;
+        }
+        case pl0_ast_stmt::type_t::CALL_PROC: {
+            auto s = dynamic_cast<pl0_ast_call_proc const *>(stmt);
+            if (s->args) {
+                for (auto && arg: s->args->args) {
+                    pl0_resolve_expr(arg->arg);
+                }
+            }
+            if (!pl0_bind(proctb, s->id)) {
+                pl0_ast_error(s->id->loc, "use of undeclared identifier '" + s->id->id.str() + "'");
+            }
+            break;
+        }
+        case pl0_ast_stmt::type_t::COMPOUND_STMT:
+            for (auto && s: dynamic_cast<pl0_ast_compound_stmt const *>(stmt)->stmt) {
+                pl0_resolve_stmt(s);
+            }
+            break;
+        case pl0_ast_stmt::type_t::WRITE_STMT: {
+            auto s = dynamic_cast<pl0_ast_write_stmt const *>(stmt);
+            if (s->t != pl0_ast_write_stmt::type_t::ONLY_STRING) {
+                pl0_resolve_expr(s->expr);
+            }
+            break;
+        }
+        case pl0_ast_stmt::type_t::READ_STMT:
+            for (auto && id: dynamic_cast<pl0_ast_read_stmt const *>(stmt)->ids) {
+                if (!pl0_bind(vartb, id)) {
+                    pl0_ast_error(id->loc, string("use of undeclared variable ") + "\"" + id->id.str() + "\"");
+                }
+            }
+            break;
+        case pl0_ast_stmt::type_t::FOR_STMT: {
+            auto s = dynamic_cast<pl0_ast_for_stmt const *>(stmt);
+            pl0_resolve_expr(s->initial);
+            pl0_resolve_expr(s->end);
+            if (!pl0_bind(vartb, s->iter)) {
+                pl0_ast_error(s->iter->loc, string("undeclared identifier ") + "\"" + s->iter->id.str() + "\"");
+            }
+            pl0_resolve_stmt(s->stmt);
+            break;
+        }
+        case pl0_ast_stmt::type_t::NULL_STMT: break;
+        default: cout << "UNIMPLEMENT STMT TYPE" << endl;
+    }
+}
+
+static void pl0_resolve_expr(pl0_ast_expression const *expr) {
+    for (auto && term: expr->terms) {
+        for (auto && factor: term.second->factors) {
+            pl0_resolve_factor(factor.second);
+        }
+    }
+}
+
+static void pl0_resolve_factor(pl0_ast_factor const *factor) {
+    int d1, d2;
+    switch (factor->t) {
+        case pl0_ast_factor::type_t::ID:
+            d1 = valtb.depth(factor->ptr.id->id), d2 = vartb.depth(factor->ptr.id->id);
+            if (d1 > d2) {
+                pl0_bind(valtb, factor->ptr.id); // constant
+            }
+            else if (d2 > d1) {
+                pl0_bind(vartb, factor->ptr.id); // variable
+            }
+            else {
+                pl0_ast_error(factor->loc, string("use of undeclared identifier ") + "\"" + factor->ptr.id->id.str() + "\"");
+            }
+            break;
+        case pl0_ast_factor::type_t::EXPR:
+            pl0_resolve_expr(factor->ptr.expr);
+            break;
+        case pl0_ast_factor::type_t::CALL_FUNC:
+            pl0_resolve_call_func(factor->ptr.call_func);
+            break;
+        case pl0_ast_factor::type_t::ARRAY_E:
+            if (!pl0_bind(vartb, factor->arraye.first)) {
+                pl0_ast_error(factor->loc, string("use of undeclared identifier ") + "\"" + factor->arraye.first->id.str() + "\"");
+            }
+            pl0_resolve_expr(factor->arraye.second);
+            break;
+        default:
+            break;
+    }
+}
+
+static void pl0_resolve_call_func(pl0_ast_call_func const *stmt) {
+    // a single identifier can be a function id or just simple variable. STRATEGY: choose the nested one.
+    pl0_sym_t fid = stmt->fn->id;
+    if (!stmt->args || stmt->args->args.empty()) {
+        int d1 = valtb.depth(fid), d2 = vartb.depth(fid), d3 = functb.depth(fid);
+        if (d1 > d2 && d1 > d3) {
+            pl0_bind(valtb, stmt->fn);
+            return;
+        }
+        if (d2 > d3) {
+            pl0_bind(vartb, stmt->fn);
+            return;
+        }
+    }
+    if (!pl0_bind(functb, stmt->fn)) {
+        pl0_ast_error(stmt->loc, string("use of undeclared identifier ") + "\"" + fid.str() + "\"");
+    }
+    if (stmt->args) {
+        for (auto && arg: stmt->args->args) {
+            pl0_resolve_expr(arg->arg);
+        }
+    }
+}
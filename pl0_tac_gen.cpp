@@ -14,13 +14,12 @@
 
 bool pl0_tac_program(pl0_ast_program const *program);
 void pl0_tac_prog(pl0_ast_prog const *prog);
-void pl0_tac_const_stmt(pl0_ast_const_stmt const *stmts);
 void pl0_tac_var_stmt(pl0_ast_var_stmt const *stmts);
 void pl0_tac_procedure_stmt(pl0_ast_procedure_stmt const *stmts);
 void pl0_tac_function_stmt(pl0_ast_function_stmt const *stmts);
-vector<string> pl0_tac_procedure_header(pl0_ast_procedure_header const *header);
-vector<string> pl0_tac_function_header(pl0_ast_function_header const *header);
-vector<string> pl0_tac_param(pl0_ast_param_list const *param);
+void pl0_tac_procedure_header(pl0_ast_procedure_header const *header);
+void pl0_tac_function_header(pl0_ast_function_header const *header);
+void pl0_tac_param(pl0_ast_param_list const *param);
 void pl0_tac_compound_stmt(pl0_ast_compound_stmt const *stmt);
 void pl0_tac_stmt(pl0_ast_stmt const *stmt);
 void pl0_tac_assign_stmt(pl0_ast_assign_stmt const *stmt);
@@ -31,52 +30,41 @@ void pl0_tac_case_stmt(pl0_ast_case_stmt const *stmt);
 void pl0_tac_read_stmt(pl0_ast_read_stmt const *stmt);
 void pl0_tac_write_stmt(pl0_ast_write_stmt const *stmt);
 void pl0_tac_null_stmt(pl0_ast_null_stmt const *stmt);
-pair<Value *, string> pl0_tac_expr(pl0_ast_expression const *expr);
-pair<Value *, string> pl0_tac_term(pl0_ast_term const *term);
-pair<Value *, string> pl0_tac_factor(pl0_ast_factor const * factor);
-pair<Value *, string> pl0_tac_call_func(pl0_ast_call_func const *stmt);
+pair<Value *, pl0_type_t> pl0_tac_expr(pl0_ast_expression const *expr);
+pair<Value *, pl0_type_t> pl0_tac_term(pl0_ast_term const *term);
+pair<Value *, pl0_type_t> pl0_tac_factor(pl0_ast_factor const * factor);
+pair<Value *, pl0_type_t> pl0_tac_call_func(pl0_ast_call_func const *stmt);
 
 extern struct IRBuilder irb;
 
 static bool status = true;
 
-static std::vector<std::string> scope;
-static std::string scope_name() {
-    string name = "";
-    for (auto && s: scope) {
-        name = name + "_" + s;
-    }
-    return name;
-}
-static pl0_env<struct variable> vartb;
-static pl0_env<struct constant> valtb;
-static pl0_env<struct proc> proctb;
-static pl0_env<struct func> functb;
+// what an unbound identifier (reported by the resolver) stands for.
+static variable const unbound_var;
+static proc const unbound_proc;
+static func const unbound_func;
 
 
-void pl0_ast_error(pair<int, int> loc, string msg) {
+void pl0_ast_error(pl0_loc_t loc, string msg) {
     status = false;
-    cout << loc.first << ":" << loc.second << " " << "ERRRO: " << msg << endl;
+    pair<int, int> pos = pl0_locate(loc);
+    cout << pos.first << ":" << pos.second << " " << "ERRRO: " << msg << endl;
 }
 
 bool pl0_tac_program(pl0_ast_program const *program) {
     cout << __func__;
-    irb.emit("program", "");
-    irb.emit("procedure", "_main");
+    irb.emit(TAC::PROGRAM, "");
+    irb.emit(TAC::PROCEDURE, "_main");
     pl0_tac_prog(program->program);
-    irb.emit("exit", new Value(0, "integer")); // main function: exit with 0.
-    irb.emit("endproc", "_main");
-    irb.emit("endprogram", "");
+    irb.emit(TAC::EXIT, pl0_values.imm(0, pl0_type_t::INTEGER)); // main function: exit with 0.
+    irb.emit(TAC::ENDPROC, "_main");
+    irb.emit(TAC::ENDPROGRAM, "");
     return status;
 }
 
 void pl0_tac_prog(pl0_ast_prog const *prog) {
     cout << __func__;
-    // set up new flag.
-    valtb.tag(); vartb.tag();
-    proctb.tag(); functb.tag();
-    pl0_tac_const_stmt(prog->consts);
-    pl0_tac_var_stmt(prog->vars);
+    pl0_tac_var_stmt(prog->vars); // constants are bound to their values by the resolver, they emit nothing.
     for (auto && e: prog->exes) {
         switch (e->t) {
             case pl0_ast_executable::type_t::PROCEDURE:
@@ -88,47 +76,16 @@ void pl0_tac_prog(pl0_ast_prog const *prog) {
     }
     irb.emitlabel(irb.makelabel());
     pl0_tac_compound_stmt(prog->stmts);
-    // pop stack.
-    valtb.detag(); vartb.detag();
-    proctb.detag(), functb.detag();
-}
-
-void pl0_tac_const_stmt(pl0_ast_const_stmt const *stmts) {
-    cout << __func__;
-    if (!stmts) { return; }
-    for (auto && def: stmts->stmt) {
-        string id = def->id->id;
-        // validate.
-        if (!scope.empty() && id == scope.back()) {
-            pl0_ast_error(def->id->loc, string("duplicate identifier ") + "\"" + id + "\"");
-        }
-        else if (valtb.find(id, false) || vartb.find(id, false)) {
-            pl0_ast_error(def->id->loc, string("redefinition of ") + "\"" + id + "\"");
-        }
-        else {
-            valtb.push(constant(id, def->val->val, (def->val->dt == pl0_ast_constv::INT ? "integer" : "char"))); // update symbol table.
-        }
-    }
-    cout << __func__;
 }
 
 void pl0_tac_var_stmt(pl0_ast_var_stmt const *stmts) {
     cout << __func__;
     if (!stmts) { return; }
     for (auto && s: stmts->stmt) {
-        for (auto && var: s->ids) {
-            // validate.
-            if (!scope.empty() && var->id == scope.back()) {
-                pl0_ast_error(var->loc, string("duplicate identifier ") + "\"" + var->id + "\"");
-            }
-            else if (valtb.find(var->id, false) || vartb.find(var->id, false)) {
-                pl0_ast_error(var->loc, string("redefinition of ") + "\"" + var->id + "\"");
-            }
-            else {
-                string t = s->type->type->type + (s->type->len == -1 ? "" : "array");
-                vartb.push(variable(var->id, s->type->type->type, t, s->type->len)); // update symbol table.
-                irb.emit("def", new Value(var->id, s->type->type->type), new Value(t, "string"), new Value(s->type->len, "integer"));
-            }
+        for (auto && id: s->ids) {
+            if (id->binding.kind != pl0_ast_binding::VARIABLE) { continue; } // an invalid definition.
+            variable const *var = id->binding.var;
+            irb.emit(TAC::DEF, pl0_values.var(var->name, var->dt, id->binding.slot), nullptr, pl0_values.imm(var->len, pl0_type_t::INTEGER));
         }
     }
 }
@@ -136,90 +93,47 @@ void pl0_tac_var_stmt(pl0_ast_var_stmt const *stmts) {
 void pl0_tac_procedure_stmt(pl0_ast_procedure_stmt const *stmts) {
     cout << __func__;
     for (auto && p: stmts->procs) {
-        // validate.
-        string pid = p.first->id->id;
-        if (valtb.find(pid, false) || vartb.find(pid, false) || proctb.find(pid, false) || functb.find(pid, false)
-                || (!scope.empty() && pid == scope.back())) {
-            pl0_ast_error(p.first->id->loc, string("overloaded identifier ") + "\"" + pid + "\"" + " isn't a function");
-        }
-        else {
-            scope.emplace_back(pid); // update global scope.
-            vector<string> proctype = pl0_tac_procedure_header(p.first);
-            irb.emit("procedure", new Value(scope_name(), "string"));
-            proctb.push(proc(scope_name(), proctype)); // update symbol table.
-            proctb.tag(); functb.tag();
-            pl0_tac_prog(p.second);
-            irb.emit("endproc", new Value(scope_name(), "string"));
-            // end of current scope.
-            scope.pop_back(); // restore scope.
-            valtb.detag(); vartb.detag();
-            proctb.detag(), functb.detag();
-        }
+        if (p.first->id->binding.kind != pl0_ast_binding::PROCEDURE) { continue; } // an invalid definition.
+        pl0_sym_t name = p.first->id->binding.proc->name;
+        pl0_tac_procedure_header(p.first);
+        irb.emit(TAC::PROCEDURE, pl0_values.name(name, pl0_type_t()));
+        pl0_tac_prog(p.second);
+        irb.emit(TAC::ENDPROC, pl0_values.name(name, pl0_type_t()));
     }
 }
 
 void pl0_tac_function_stmt(pl0_ast_function_stmt const *stmts) {
     cout << __func__;
     for (auto && f: stmts->funcs) {
-        // validate.
-        string fid = f.first->id->id;
-        if (valtb.find(fid, false) || vartb.find(fid, false) || proctb.find(fid, false) || functb.find(fid, false)
-                || (!scope.empty() && fid == scope.back())) {
-            pl0_ast_error(f.first->id->loc, string("overloaded identifier ") + "\"" + fid + "\"" + " isn't a function");
-        }
-        else {
-            scope.emplace_back(fid); // update global scope.
-            vector<string> functype = pl0_tac_function_header(f.first);
-            irb.emit("function", new Value(scope_name(), "string"));
-            functb.push(func(scope_name(), f.first->type->type, functype)); // update symbol table
-            proctb.tag(); functb.tag();
-            irb.emit("def", new Value(scope_name(), f.first->type->type), new Value("function", "string"), new Value(-1, "integer"));
-            pl0_tac_prog(f.second);
-            irb.emit("loadret", new Value(scope_name(), "string"));
-            irb.emit("endfunc", new Value(scope_name(), "string"));
-            // end of current scope.
-            scope.pop_back(); // restore scope.
-            valtb.detag(); vartb.detag();
-            proctb.detag(), functb.detag();
-        }
+        if (f.first->id->binding.kind != pl0_ast_binding::FUNCTION) { continue; } // an invalid definition.
+        pl0_sym_t name = f.first->id->binding.func->name;
+        pl0_tac_function_header(f.first);
+        irb.emit(TAC::FUNCTION, pl0_values.name(name, pl0_type_t()));
+        irb.emit(TAC::DEF, pl0_values.var(name, f.first->type->dt, f.first->id->binding.slot), nullptr, pl0_values.imm(-1, pl0_type_t::INTEGER));
+        pl0_tac_prog(f.second);
+        irb.emit(TAC::LOADRET, pl0_values.name(name, pl0_type_t()));
+        irb.emit(TAC::ENDFUNC, pl0_values.name(name, pl0_type_t()));
     }
 }
 
-vector<string> pl0_tac_procedure_header(pl0_ast_procedure_header const *header) {
+void pl0_tac_procedure_header(pl0_ast_procedure_header const *header) {
     cout << __func__;
-    return pl0_tac_param(header->params);
+    pl0_tac_param(header->params);
 }
 
-vector<string> pl0_tac_function_header(pl0_ast_function_header const *header) {
+void pl0_tac_function_header(pl0_ast_function_header const *header) {
     cout << __func__;
-    return pl0_tac_param(header->params);
+    pl0_tac_param(header->params);
 }
 
-vector<string> pl0_tac_param(pl0_ast_param_list const *param) {
+void pl0_tac_param(pl0_ast_param_list const *param) {
     cout << __func__;
-    // set up new flag, new scope.
-    valtb.tag(); vartb.tag();
-    
-    if (!param) { return vector<string>(); } // no parameter.
-    vector<string> type;
+    if (!param) { return; } // no parameter.
     for (auto && group: param->params) {
         for (auto && id: group->ids) {
-            // validte.
-            if (vartb.find(id->id, false) || id->id == scope.back()) {
-                pl0_ast_error(id->loc, string("duplicate parameter ") + id->id);
-            }
-            vartb.push(variable(id->id, group->type->type, group->type->type)); // add parameters to symbol table.
-            if (group->is_ref) {
-                type.emplace_back(string("ref_") + group->type->type);
-                irb.emit("paramref", new Value(id->id, group->type->type), new Value(group->type->type, "string"));
-            }
-            else {
-                type.emplace_back(group->type->type);
-                irb.emit("param", new Value(id->id, group->type->type), new Value(group->type->type, "string"));
-            }
+            irb.emit(group->is_ref ? TAC::PARAMREF : TAC::PARAM, pl0_values.var(id->id, group->type->dt, id->binding.slot));
         }
     }
-    return type;
 }
 
 void pl0_tac_compound_stmt(pl0_ast_compound_stmt const *compound_stmt) {
@@ -232,6 +146,8 @@ void pl0_tac_compound_stmt(pl0_ast_compound_stmt const *compound_stmt) {
 void pl0_tac_stmt(pl0_ast_stmt const *stmt) {
     cout << __func__;
     if (stmt == nullptr) { return; } // check if null pointer.
+    pl0_loc_t outer = irb.loc; // the code is located at the innermost statement.
+    irb.loc = stmt->loc;
     switch (stmt->t) {
         case pl0_ast_stmt::type_t::ASSIGN_STMT: pl0_tac_assign_stmt(dynamic_cast<pl0_ast_assign_stmt const *>(stmt)); break;
         case pl0_ast_stmt::type_t::COND_STMT: pl0_tac_cond_stmt(dynamic_cast<pl0_ast_cond_stmt const *>(stmt)); break;
@@ -244,45 +160,49 @@ void pl0_tac_stmt(pl0_ast_stmt const *stmt) {
         case pl0_ast_stmt::type_t::NULL_STMT: pl0_tac_null_stmt(dynamic_cast<pl0_ast_null_stmt const *>(stmt)); break;
         default: cout << "UNIMPLEMENT STMT TYPE" << endl;
     }
+    irb.loc = outer;
 }
 
 void pl0_tac_assign_stmt(pl0_ast_assign_stmt const *stmt) {
-    variable var;
     Value *val = pl0_tac_expr(stmt->val).first;
-    if (stmt->idx == nullptr && functb.depth(stmt->id->id) > vartb.depth(stmt->id->id)) {
+    if (stmt->id->binding.kind == pl0_ast_binding::FUNCTION) {
         // set function's retval
-        func f;
-        if (functb.find(stmt->id->id, true, f) == false) {
-            pl0_ast_error(stmt->id->loc, string("use of undeclared function ") + "\"" + stmt->id->id + "\"");
-        }
-        irb.emit("=", new Value(f.name, f.rettype), val);
+        func const & f = *stmt->id->binding.func;
+        irb.emit(TAC::ASSIGN, pl0_values.var(f.name, f.rettype, stmt->id->binding.slot), val);
     }
     else {
         // just simple assign.
-        if (stmt->id->id.front() == '^') {
-            pl0_ast_error(stmt->id->loc, string("illegal assign to loop variable"));
-        }
-        if (vartb.find(stmt->id->id, true, var) == false) {
-            pl0_ast_error(stmt->id->loc, string("use of undeclared identifier ") + "\"" + stmt->id->id + "\"");
-        }
+        variable const & var = stmt->id->binding.kind == pl0_ast_binding::VARIABLE ? *stmt->id->binding.var : unbound_var;
         // assign to array element.
         if (stmt->idx) {
             if (var.len == -1) {
-                pl0_ast_error(stmt->id->loc, string("treat ordinary variable ") + "\"" + stmt->id->id + "\" as an array");
+                pl0_ast_error(stmt->id->loc, string("treat ordinary variable ") + "\"" + stmt->id->id.str() + "\" as an array");
             }
             Value *idx = pl0_tac_expr(stmt->idx).first;
-            irb.emit("[]=", new Value(stmt->id->id, var.dt), idx, val);
+            irb.emit(TAC::STORE_ELEM, pl0_values.var(stmt->id->id, var.dt, stmt->id->binding.slot), idx, val);
         }
         // assign to variable.
         else {
             if (var.len != -1) {
-                pl0_ast_error(stmt->id->loc, string("expected an non-array identifier ") + "\"" + stmt->id->id + "\"");
+                pl0_ast_error(stmt->id->loc, string("expected an non-array identifier ") + "\"" + stmt->id->id.str() + "\"");
             }
-            irb.emit("=", new Value(stmt->id->id, var.dt), val);
+            irb.emit(TAC::ASSIGN, pl0_values.var(stmt->id->id, var.dt, stmt->id->binding.slot), val);
         }
     }
 }
 
+// the jump to the else branch, taken when the condition doesn't hold.
+static TAC::cond_t pl0_tac_negate(pl0_ast_comp_op::op_t op) {
+    switch (op) {
+        case pl0_ast_comp_op::LT: return TAC::JGE;
+        case pl0_ast_comp_op::LE: return TAC::JG;
+        case pl0_ast_comp_op::GT: return TAC::JLE;
+        case pl0_ast_comp_op::GE: return TAC::JL;
+        case pl0_ast_comp_op::EQ: return TAC::JNE;
+        default: return TAC::JE;
+    }
+}
+
 void pl0_tac_cond_stmt(pl0_ast_cond_stmt const *stmt) {
     cout << __func__;
 
@@ -293,7 +213,7 @@ void pl0_tac_cond_stmt(pl0_ast_cond_stmt const *stmt) {
     // if (lhs.second != rhs.second) {
     //     pl0_ast_error(stmt->cond->loc, "compare two expressions with different types.");
     // }
-    irb.emit("cmp", new Value(thenlabel, "integer"), lhs.first, rhs.first);
+    irb.emit(TAC::CMP, pl0_values.label(thenlabel), lhs.first, rhs.first);
 
     if (stmt->else_block == nullptr) {
         elselabel = endlabel;
@@ -317,31 +237,14 @@ void pl0_tac_cond_stmt(pl0_ast_cond_stmt const *stmt) {
     // | JG/    | Jump if greater              | signed      | ZF = 0 and SF = OF |
     // | JNLE   | Jump if not less or equal    |             |                    |
     // +--------+------------------------------+-------------+--------------------+
-    if (stmt->cond->op->op == "<") {
-        irb.emit("goto", new Value("jge", "string"), new Value(elselabel, "integer"));
-    }
-    else if (stmt->cond->op->op == "<=") {
-        irb.emit("goto", new Value("jg", "string"), new Value(elselabel, "integer"));
-    }
-    else if (stmt->cond->op->op == ">") {
-        irb.emit("goto", new Value("jle", "string"), new Value(elselabel, "integer"));
-    }
-    else if (stmt->cond->op->op == ">=") {
-        irb.emit("goto", new Value("jl", "string"), new Value(elselabel, "integer"));
-    }
-    else if (stmt->cond->op->op == "=") {
-        irb.emit("goto", new Value("jne", "string"), new Value(elselabel, "integer"));
-    }
-    else if (stmt->cond->op->op == "<>") {
-        irb.emit("goto", new Value("je", "string"), new Value(elselabel, "integer"));
-    }
+    irb.emitgoto(pl0_tac_negate(stmt->cond->op->op), elselabel);
     irb.emitlabel(thenlabel);
     pl0_tac_stmt(stmt->then_block);
-    irb.emit("goto", new Value("jmp", "string"), new Value(endlabel, "integer"));
+    irb.emitgoto(TAC::JMP, endlabel);
     if (stmt->else_block != nullptr) {
         irb.emitlabel(elselabel);
         pl0_tac_stmt(stmt->else_block);
-        irb.emit("goto", new Value("jmp", "string"), new Value(endlabel, "integer"));
+        irb.emitgoto(TAC::JMP, endlabel);
     }
     irb.emitlabel(endlabel);
 }
@@ -351,46 +254,42 @@ void pl0_tac_case_stmt(pl0_ast_case_stmt const *stmt) {
     auto case_cond = pl0_tac_expr(stmt->expr);
     // add case condition value to symbol table.
     Value *cond;
-    if (case_cond.first->t == Value::TYPE::STR && case_cond.first->sv[0] == '~') {
-        cond = new Value(string("~") + case_cond.first->sv, case_cond.second);
-        irb.emit("def", cond, new Value(case_cond.second, "string"), new Value(-1, "integer"));
-        irb.emit("=", cond, case_cond.first);
+    if (case_cond.first->t == Value::TEMP || case_cond.first->t == Value::ELEM) {
+        cond = pl0_values.temp(irb.maketmp(), case_cond.second);
+        irb.emit(TAC::DEF, cond, nullptr, pl0_values.imm(-1, pl0_type_t::INTEGER));
+        irb.emit(TAC::ASSIGN, cond, case_cond.first);
     }
     else {
         cond = case_cond.first;
     }
     int endlabel = irb.makelabel();
     std::vector<int> labels;
-    for (auto && item: stmt->terms) {
+    for (size_t i = 0; i < stmt->terms.size(); ++i) {
         labels.emplace_back(irb.makelabel());
     }
     labels.emplace_back(endlabel);
-    irb.emit("goto", new Value("jmp", "string"), new Value(labels[0], "integer"));
+    irb.emitgoto(TAC::JMP, labels[0]);
     for (size_t i = 0; i < stmt->terms.size(); ++i) {
         int t = irb.makelabel();
         irb.emitlabel(labels[i]);
-        irb.emit("cmp", new Value(t, "integer"), cond, new Value(stmt->terms[i]->constv->val, "integer"));
-        irb.emit("goto", new Value("jne", "string"), new Value(labels[i+1], "integer"));
+        irb.emit(TAC::CMP, pl0_values.label(t), cond, pl0_values.imm(stmt->terms[i]->constv->val, pl0_type_t::INTEGER));
+        irb.emitgoto(TAC::JNE, labels[i+1]);
         irb.emitlabel(t);
         pl0_tac_stmt(stmt->terms[i]->stmt);
-        irb.emit("goto", new Value("jmp", "string"), new Value(endlabel, "integer"));
+        irb.emitgoto(TAC::JMP, endlabel);
     }
     irb.emitlabel(endlabel);
 }
 
 void pl0_tac_call_proc(pl0_ast_call_proc const *stmt) {
     cout << __func__;
-    std::vector<std::pair<Value *, std::string>> args;
+    std::vector<std::pair<Value *, pl0_type_t>> args;
     if (stmt->args) {
         for (auto argexpr: stmt->args->args) {
             args.emplace(args.begin(), pl0_tac_expr(argexpr->arg));
         }
     }
-    proc p;
-    proctb.find(stmt->id->id, true, p);
-    if (p.name.length() == 0) {
-        pl0_ast_error(stmt->id->loc, "use of undeclared identifier '" + stmt->id->id + "'");
-    }
+    proc const & p = stmt->id->binding.kind == pl0_ast_binding::PROCEDURE ? *stmt->id->binding.proc : unbound_proc;
     std::vector<std::pair<Value *, bool>> pushes; // <Value * val, bool is_ref>
     if (args.size() != p.param_t.size()) {
         pl0_ast_error(stmt->args->loc, string("unmatched number of parameters and arguments."));
@@ -398,12 +297,12 @@ void pl0_tac_call_proc(pl0_ast_call_proc const *stmt) {
     else {
         size_t len = args.size();
         for (size_t i = 0; i < len; ++i) {
-            bool is_ref = p.param_t[len-1-i].length() > 4 && p.param_t[len-1-i].substr(0, 4) == "ref_";
+            bool is_ref = p.param_t[len-1-i].ref;
             // if (args[i].second != (is_ref ? p.param_t[len-1-i].substr(4): p.param_t[len-1-i])) {
             //     pl0_ast_error(stmt->args->args[i]->loc, string("unmatched type of parameter and argument."));
             // }
             if (is_ref) {
-                if (args[i].first->t == Value::TYPE::IMM || (args[i].first->sv.back() != '#' && args[i].first->sv.front() == '~')) {
+                if (args[i].first->t == Value::IMM || args[i].first->t == Value::TEMP) {
                     pl0_ast_error(stmt->args->args[i]->loc, string("use constant or expression as reference value."));
                 }
                 pushes.emplace_back(make_pair(args[i].first, true));
@@ -413,8 +312,8 @@ void pl0_tac_call_proc(pl0_ast_call_proc const *stmt) {
             }
         }
     }
-    irb.emit("call", new Value(p.name, "string"), pushes);
-    irb.emit("label", new Value(irb.makelabel(), "integer"), new Value("allsuffix", "string"));
+    irb.emit(TAC::CALL, pl0_values.name(p.name, pl0_type_t()), pushes);
+    irb.emit(TAC::LABEL, pl0_values.label(irb.makelabel()), pl0_values.mark(Value::AFTER_CALL));
 }
 
 void pl0_tac_for_stmt(pl0_ast_for_stmt const *stmt) {
@@ -423,61 +322,57 @@ void pl0_tac_for_stmt(pl0_ast_for_stmt const *stmt) {
     int beginlabel = irb.makelabel(), frontlabel = irb.makelabel();
     int innerlabel = irb.makelabel();
     int endlabel = irb.makelabel(), taillabel = irb.makelabel();
-    pair<Value *, string> s = pl0_tac_expr(stmt->initial);
-    pair<Value *, string> t = pl0_tac_expr(stmt->end);
+    pair<Value *, pl0_type_t> s = pl0_tac_expr(stmt->initial);
+    pair<Value *, pl0_type_t> t = pl0_tac_expr(stmt->end);
     
-    // validate loop iterator.
-    variable var;
-    if (vartb.find(stmt->iter->id, true, var) == false) {
-        pl0_ast_error(stmt->iter->loc, string("undeclared identifier ") + "\"" + stmt->iter->id + "\"");
-    }
-    if (s.second != "integer" && s.second != "char") {
+    variable const & var = stmt->iter->binding.kind == pl0_ast_binding::VARIABLE ? *stmt->iter->binding.var : unbound_var;
+    if (!s.second.scalar()) {
         pl0_ast_error(stmt->initial->loc, "use array as initial value in for loop");
     }
 
 ////////////////////////////////////////////////////////////////////////////////////
-    irb.emit("cmp", new Value(frontlabel, "integer"), s.first, t.first);
+    irb.emit(TAC::CMP, pl0_values.label(frontlabel), s.first, t.first);
     if (stmt->step->val == 1) {
-        irb.emit("goto", new Value("jg", "string"), new Value(taillabel, "integer"));
+        irb.emitgoto(TAC::JG, taillabel);
     }
     else {
-        irb.emit("goto", new Value("jl", "string"), new Value(taillabel, "integer"));
+        irb.emitgoto(TAC::JL, taillabel);
     }
     irb.emitlabel(frontlabel);
 /////////////////////////////////////////////////////////////////////////////////////
 
     Value *end;
-    if (t.first->t == Value::TYPE::STR && t.first->sv[0] == '~') {
-        end = new Value("~" + t.first->sv, t.second);
-        irb.emit("def", end, new Value(t.second, "string"), new Value(-1, "integer"));
-        irb.emit("=", end, t.first);
+    if (t.first->t == Value::TEMP || t.first->t == Value::ELEM) {
+        end = pl0_values.temp(irb.maketmp(), t.second);
+        irb.emit(TAC::DEF, end, nullptr, pl0_values.imm(-1, pl0_type_t::INTEGER));
+        irb.emit(TAC::ASSIGN, end, t.first);
     }
     else {
         end = t.first;
     }
 
-    irb.emit("=", new Value(stmt->iter->id, var.dt), s.first);
-    irb.emit("goto", new Value("jmp", "string"), new Value(beginlabel, "integer"));
+    irb.emit(TAC::ASSIGN, pl0_values.var(stmt->iter->id, var.dt, stmt->iter->binding.slot), s.first);
+    irb.emitgoto(TAC::JMP, beginlabel);
     irb.emitlabel(beginlabel);
-    if (t.second != "integer" && t.second != "char") {
+    if (!t.second.scalar()) {
         pl0_ast_error(stmt->end->loc, "use array as end value in for loop");
     }
     // add end value to symbol table.
     
-    irb.emit("cmp", new Value(innerlabel, "integer"), new Value(stmt->iter->id, var.dt), end);
+    irb.emit(TAC::CMP, pl0_values.label(innerlabel), pl0_values.var(stmt->iter->id, var.dt, stmt->iter->binding.slot), end);
     if (stmt->step->val == 1) {
-        irb.emit("goto", new Value("jg", "string"), new Value(endlabel, "integer"));
+        irb.emitgoto(TAC::JG, endlabel);
     }
     else {
-        irb.emit("goto", new Value("jl", "string"), new Value(endlabel, "integer"));
+        irb.emitgoto(TAC::JL, endlabel);
     }
     irb.emitlabel(innerlabel); // label for inner executable block.
     pl0_tac_stmt(stmt->stmt);
-    irb.emit("+", new Value(stmt->iter->id, var.dt), new Value(stmt->iter->id, var.dt), new Value(stmt->step->val, "integer"));
-    irb.emit("goto", new Value("jmp", "string"), new Value(beginlabel, "integer"));
+    irb.emit(TAC::ADD, pl0_values.var(stmt->iter->id, var.dt, stmt->iter->binding.slot), pl0_values.var(stmt->iter->id, var.dt, stmt->iter->binding.slot), pl0_values.imm(stmt->step->val, pl0_type_t::INTEGER));
+    irb.emitgoto(TAC::JMP, beginlabel);
     irb.emitlabel(endlabel);
-    irb.emit("=", new Value(stmt->iter->id, var.dt), t.first);
-    irb.emit("goto", new Value("jmp", "string"), new Value(taillabel, "integer"));
+    irb.emit(TAC::ASSIGN, pl0_values.var(stmt->iter->id, var.dt, stmt->iter->binding.slot), t.first);
+    irb.emitgoto(TAC::JMP, taillabel);
     irb.emitlabel(taillabel);
 }
 
@@ -485,15 +380,12 @@ void pl0_tac_read_stmt(pl0_ast_read_stmt const *stmt) {
     cout << __func__;
     for (auto && id: stmt->ids) {
         // validate.
-        variable var;
-        if (vartb.find(id->id, true, var) == false) {
-            pl0_ast_error(id->loc, string("use of undeclared variable ") + "\"" + id->id + "\"");
-        }
+        variable const & var = id->binding.kind == pl0_ast_binding::VARIABLE ? *id->binding.var : unbound_var;
         if (var.len != -1) {
-            pl0_ast_error(id->loc, string("expected an non-array identifier ") + "\"" + id->id + "\"");
+            pl0_ast_error(id->loc, string("expected an non-array identifier ") + "\"" + id->id.str() + "\"");
         }
-        irb.emit("=", new Value(id->id, var.dt), new Value(0, var.dt));
-        irb.emit("read", new Value(id->id, var.dt));
+        irb.emit(TAC::ASSIGN, pl0_values.var(id->id, var.dt, id->binding.slot), pl0_values.imm(0, var.dt));
+        irb.emit(TAC::READ, pl0_values.var(id->id, var.dt, id->binding.slot));
     }
 }
 
@@ -501,14 +393,14 @@ void pl0_tac_write_stmt(pl0_ast_write_stmt const *stmt) {
     cout << __func__;
     switch (stmt->t) {
         case pl0_ast_write_stmt::type_t::ONLY_STRING:
-            irb.emit("write_s", new Value(stmt->str->val, "string"), new Value(irb.makelabel(), "integer"));
+            irb.emit(TAC::WRITE_S, pl0_values.text(stmt->str->val), pl0_values.label(irb.makelabel()));
             break;
         case pl0_ast_write_stmt::type_t::ONLY_EXPR:
-            irb.emit("write_e", pl0_tac_expr(stmt->expr).first);
+            irb.emit(TAC::WRITE_E, pl0_tac_expr(stmt->expr).first);
             break;
         case pl0_ast_write_stmt::type_t::STRING_AND_EXPR:
-            irb.emit("write_s", new Value(stmt->str->val, "string"), new Value(irb.makelabel(), "integer"));
-            irb.emit("write_e", pl0_tac_expr(stmt->expr).first);
+            irb.emit(TAC::WRITE_S, pl0_values.text(stmt->str->val), pl0_values.label(irb.makelabel()));
+            irb.emit(TAC::WRITE_E, pl0_tac_expr(stmt->expr).first);
             break;
         default: cout << "UNIMPLEMENT WRITE TYPE" << endl;
     }
@@ -518,87 +410,92 @@ void pl0_tac_null_stmt(pl0_ast_null_stmt const *) {
     cout << __func__;
 }
 
-pair<Value *, string> pl0_tac_expr(pl0_ast_expression const *expr) {
+// opcode of an arithmetic operator.
+static TAC::op_t pl0_tac_arith(char op) {
+    switch (op) {
+        case '+': return TAC::ADD;
+        case '-': return TAC::SUB;
+        case '*': return TAC::MUL;
+        case '/': return TAC::DIV;
+        default: return TAC::MOD;
+    }
+}
+
+pair<Value *, pl0_type_t> pl0_tac_expr(pl0_ast_expression const *expr) {
     cout << __func__;
     bool needtmp = true;
     std::string t = "";
-    pair<Value *, string> head = pl0_tac_term(expr->terms[0].second);
+    pair<Value *, pl0_type_t> head = pl0_tac_term(expr->terms[0].second);
     Value *ans = head.first, *prev = head.first;
     if (expr->terms[0].first->op == '-') {
-        ans = new Value(irb.maketmp(), head.second);
-        irb.emit("-", ans, new Value(0, head.second), prev);
+        ans = pl0_values.temp(irb.maketmp(), head.second);
+        irb.emit(TAC::SUB, ans, pl0_values.imm(0, head.second), prev);
         needtmp = false; // no more temporary variable.
     }
     if (expr->terms.size() > 1) {
-        head.second = "integer"; // type casting.
+        head.second = pl0_type_t::INTEGER; // type casting.
         for (size_t i = 1; i < expr->terms.size(); ++i) {
-            if (needtmp) { ans = new Value(irb.maketmp(), head.second); }
+            if (needtmp) { ans = pl0_values.temp(irb.maketmp(), head.second); }
             auto element = pl0_tac_term(expr->terms[i].second);
             // if (element.second != head.second) {
             //     pl0_ast_error(expr->terms[i].second->loc, "do +/- operation on two terms with different types.");
             // }
-            irb.emit(string(1, expr->terms[i].first->op), ans, needtmp ? prev : ans, element.first);
+            irb.emit(pl0_tac_arith(expr->terms[i].first->op), ans, needtmp ? prev : ans, element.first);
             needtmp = false; // no more temporary variable.
         }
     }
-    ans->dt = head.second;
+    ans = pl0_values.retype(ans, head.second);
     return make_pair(ans, head.second);
 }
 
-pair<Value *, string> pl0_tac_term(pl0_ast_term const *term) {
+pair<Value *, pl0_type_t> pl0_tac_term(pl0_ast_term const *term) {
     cout << __func__;
     bool needtmp = true;
-    pair<Value *, string> head = pl0_tac_factor(term->factors[0].second);
+    pair<Value *, pl0_type_t> head = pl0_tac_factor(term->factors[0].second);
     Value *ans = head.first, *prev = head.first;
     if (term->factors.size() > 1) {
-        head.second = "integer"; // type casting.
+        head.second = pl0_type_t::INTEGER; // type casting.
         for (size_t i = 1; i < term->factors.size(); ++i) {
-            if (needtmp) { ans = new Value(irb.maketmp(), head.second); }
+            if (needtmp) { ans = pl0_values.temp(irb.maketmp(), head.second); }
             auto element = pl0_tac_factor(term->factors[i].second);
             // if (element.second != head.second) {
             //     pl0_ast_error(term->factors[i].second->loc, "do *// operation on two factors with different types.");
             // }
-            irb.emit(string(1, term->factors[i].first->op), ans, needtmp ? prev : ans, element.first);
+            irb.emit(pl0_tac_arith(term->factors[i].first->op), ans, needtmp ? prev : ans, element.first);
             needtmp = false; // no more temporary variable.
         }
     }
-    ans->dt = head.second;
+    ans = pl0_values.retype(ans, head.second);
     return make_pair(ans, head.second);
 }
 
-pair<Value *, string> pl0_tac_factor(pl0_ast_factor const * factor) {
+pair<Value *, pl0_type_t> pl0_tac_factor(pl0_ast_factor const * factor) {
     cout << __func__;
-    pair<Value *, string> ans;
+    pair<Value *, pl0_type_t> ans;
     // variables used inner switch-case block.
-    int d1, d2;
-    constant val;
-    variable var, array;
-    Value *idx, *t;
+    pl0_ast_binding const *b;
+    variable array;
+    Value *base, *idx, *t;
 
     switch (factor->t) {
         case pl0_ast_factor::type_t::ID:
-            d1 = valtb.depth(factor->ptr.id->id), d2 = vartb.depth(factor->ptr.id->id);
-            if (d1 > d2) {
-                // constant
-                valtb.find(factor->ptr.id->id, true, val);
-                ans = make_pair(new Value(val.val, val.dt), "integer");
+            b = &factor->ptr.id->binding;
+            if (b->kind == pl0_ast_binding::CONSTANT) {
+                ans = make_pair(pl0_values.imm(b->val->val, b->val->dt), pl0_type_t::INTEGER);
             }
-            else if (d2 > d1) {
-                // variable
-                vartb.find(factor->ptr.id->id, true, var);
-                if (var.type.length() >= 5 && var.type.substr(0, 5) == "array") {
-                    pl0_ast_error(factor->loc, string("use an array identifier ") + "\"" + var.name + "\"" + " as a factor.");
+            else if (b->kind == pl0_ast_binding::VARIABLE) {
+                if (b->var->len != -1) {
+                    pl0_ast_error(factor->loc, string("use an array identifier ") + "\"" + b->var->name.str() + "\"" + " as a factor.");
                 }
-                ans = make_pair(new Value(var.name, var.dt), var.dt);
+                ans = make_pair(pl0_values.var(b->var->name, b->var->dt, b->slot), b->var->dt);
             }
             else {
                 // undeclared identifier
-                pl0_ast_error(factor->loc, string("use of undeclared identifier ") + "\"" + factor->ptr.id->id + "\"");
-                ans = make_pair(new Value(factor->ptr.id->id, "undefined"), "");
+                ans = make_pair(pl0_values.name(factor->ptr.id->id, pl0_type_t()), pl0_type_t());
             }
             break;
         case pl0_ast_factor::type_t::UNSIGNED:
-            ans = make_pair(new Value(factor->ptr.unsignedn->val, factor->ptr.unsignedn->dt == pl0_ast_constv::INT ? "integer" : "char"), "integer");
+            ans = make_pair(pl0_values.imm(factor->ptr.unsignedn->val, factor->ptr.unsignedn->dt == pl0_ast_constv::INT ? pl0_type_t::INTEGER : pl0_type_t::CHAR), pl0_type_t::INTEGER);
             break;
         case pl0_ast_factor::type_t::EXPR:
             ans = pl0_tac_expr(factor->ptr.expr);
@@ -608,60 +505,52 @@ pair<Value *, string> pl0_tac_factor(pl0_ast_factor const * factor) {
             break;
         case pl0_ast_factor::type_t::ARRAY_E:
             // validate array identifier.
-            if (vartb.find(factor->arraye.first->id, true, array)) {
+            if (factor->arraye.first->binding.kind == pl0_ast_binding::VARIABLE) {
+                array = *factor->arraye.first->binding.var;
                 if (array.len == -1) {
                     pl0_ast_error(factor->loc, "expected an array identifier.");
                 }
             }
             else {
-                pl0_ast_error(factor->loc, string("use of undeclared identifier ") + "\"" + factor->arraye.first->id + "\"");
                 array.name = factor->arraye.first->id; // give it a default value, although it's wrong.
             }
             // validate array index.
             idx = pl0_tac_expr(factor->arraye.second).first;
-            t = new Value(irb.maketmp()+"#"+array.name+"#"+idx->value()+"#", array.dt);
-            irb.emit("=[]", t, new Value(array.name, array.dt), idx);
-            ans = make_pair(t, array.type.substr(0, array.type.length()-5));
+            base = pl0_values.var(array.name, array.dt, factor->arraye.first->binding.slot);
+            t = pl0_values.elem(irb.maketmp(), array.dt, base, idx);
+            irb.emit(TAC::LOAD_ELEM, t, base, idx);
+            ans = make_pair(t, array.type.elem());
             break;
         default:
             pl0_ast_error(factor->loc, "undefined syntax");
-            ans = make_pair(new Value("^^^^^", "undefined"), "");
+            ans = make_pair(pl0_values.mark(Value::INVALID), pl0_type_t());
             cout << "UNIMPLEMENT EXPRESSION" << endl;
             break;
     }
     return ans;
 }
 
-pair<Value *, string> pl0_tac_call_func(pl0_ast_call_func const *stmt) {
+pair<Value *, pl0_type_t> pl0_tac_call_func(pl0_ast_call_func const *stmt) {
     cout << __func__;
     // a single identifier can be a function id or just simple variable. STRATEGY: choose the nested one.
-    string fid = stmt->fn->id;
-    if (!stmt->args || stmt->args->args.empty()) {
-        int d1 = valtb.depth(fid), d2 = vartb.depth(fid), d3 = functb.depth(fid);
-        if (d1 > d2 && d1 > d3) {
-            constant val; valtb.find(fid, true, val);
-            return make_pair(new Value(val.val, val.dt), "integer");
-        }
-        if (d2 > d3) {
-            variable var; vartb.find(fid, true, var);
-            if (var.len != -1) {
-                pl0_ast_error(stmt->loc, string("use an array ") + "\"" + var.name + "\"" + " as a factor.");
-            }
-            return make_pair(new Value(var.name, var.dt), var.type);
-        }
+    pl0_ast_binding const & b = stmt->fn->binding;
+    if (b.kind == pl0_ast_binding::CONSTANT) {
+        return make_pair(pl0_values.imm(b.val->val, b.val->dt), pl0_type_t::INTEGER);
     }
-    if (!functb.find(fid, true)) {
-        pl0_ast_error(stmt->loc, string("use of undeclared identifier ") + "\"" + fid + "\"");
+    if (b.kind == pl0_ast_binding::VARIABLE) {
+        if (b.var->len != -1) {
+            pl0_ast_error(stmt->loc, string("use an array ") + "\"" + b.var->name.str() + "\"" + " as a factor.");
+        }
+        return make_pair(pl0_values.var(b.var->name, b.var->dt, b.slot), b.var->type);
     }
-    std::vector<std::pair<Value *, std::string>> args;
+    std::vector<std::pair<Value *, pl0_type_t>> args;
     if (stmt->args) {
         for (auto argexpr: stmt->args->args) {
             auto arg = pl0_tac_expr(argexpr->arg);
             args.emplace(args.begin(), arg);
         }
     }
-    func fn;
-    functb.find(fid, true, fn);
+    func const & fn = b.kind == pl0_ast_binding::FUNCTION ? *b.func : unbound_func;
     std::vector<std::pair<Value *, bool>> pushes; // <Value * val, bool is_ref>
     if (args.size() != fn.param_t.size()) {
         pl0_ast_error(stmt->args->loc, string("unmatched number of parameters and arguments."));
@@ -669,12 +558,12 @@ pair<Value *, string> pl0_tac_call_func(pl0_ast_call_func const *stmt) {
     else {
         size_t len = args.size();
         for (size_t i = 0; i < args.size(); ++i) {
-            bool is_ref = fn.param_t[len-1-i].length() > 4 && fn.param_t[len-1-i].substr(0, 4) == "ref_";
+            bool is_ref = fn.param_t[len-1-i].ref;
             // if (args[i].second != (is_ref ? fn.param_t[len-1-i].substr(4) : fn.param_t[len-1-i])) {
             //     pl0_ast_error(stmt->args->args[i]->loc, string("unmatched type of parameter and argument."));
             // }
             if (is_ref) {
-                if (args[i].first->t == Value::TYPE::IMM || (args[i].first->sv.back() != '#' && args[i].first->sv.front() == '~')) {
+                if (args[i].first->t == Value::IMM || args[i].first->t == Value::TEMP) {
                     pl0_ast_error(stmt->args->args[i]->loc, string("use constant or expression as reference value."));
                 }
                 pushes.emplace_back(make_pair(args[i].first, true));
@@ -684,10 +573,10 @@ pair<Value *, string> pl0_tac_call_func(pl0_ast_call_func const *stmt) {
             }
         }
     }
-    string retval = irb.makeret();
-    irb.emit("call", new Value(fn.name, "string"), pushes, new Value(retval, fn.rettype));
-    irb.emit("label", new Value(irb.makelabel(), "integer"), new Value("allsuffix", "string"));
-    return make_pair(new Value(retval, fn.rettype), fn.rettype);
+    Value *retval = pl0_values.temp(irb.maketmp(), fn.rettype);
+    irb.emit(TAC::CALL, pl0_values.name(fn.name, pl0_type_t()), pushes, retval);
+    irb.emit(TAC::LABEL, pl0_values.label(irb.makelabel()), pl0_values.mark(Value::AFTER_CALL));
+    return make_pair(retval, fn.rettype);
 }
 
 #endif /* __PLO_TAC_GEN_HPP__ */
@@ -4,403 +4,421 @@ static IOOut out;
 
 static int dist = 0;
 static std::vector<int> old;
-static pl0_env<LOC> runtime;
-static SimpleAllocator manager(runtime, out, dist);
+static int depth = 0; // static depth of the frame being generated, the slots of the operands are relative to it.
+static SimpleAllocator manager(out, dist, depth);
 static vector<pair<string, string>> asciis;
 
-static size_t pl0_x86_gen_param(std::vector<TAC> & code, size_t p = 0) {
-    int size = 8; // the first argument: ebp+8
-    while (code[p].op == "param" || code[p].op == "paramref") {
-        runtime.push(LOC(code[p].rd->sv, size, code[p].op == "paramref"));
-        p = p + 1; size = size + 4;
+// the layout of a frame in the dumps.
+static std::string pl0_x86_slot(Value const *v) {
+    int offset = v->slot.offset;
+    return v->str() + ": " + (offset < 0 ? to_string(offset) : ("+" + to_string(offset))) + " is_ref: " + to_string(v->slot.ref);
+}
+
+static size_t pl0_x86_gen_param(std::vector<TAC> & code, std::vector<std::string> & layout, size_t p = 0) {
+    // the parameters are at ebp+8, ebp+12 and so on, as laid out by the resolver.
+    while (code[p].op == TAC::PARAM || code[p].op == TAC::PARAMREF) {
+        layout.emplace_back(pl0_x86_slot(code[p].rd));
+        p = p + 1;
     }
     return p;
 }
 
 static std::string x86_gen_def(TAC & code) {
     int size = 0;
-    if (code.rs->sv == "integer") {
+    if (code.rd->dt.kind == pl0_type_t::INTEGER) {
         size = code.rt->iv == -1 ? 4 : (code.rt->iv * 4);
     }
     else {
         size = code.rt->iv == -1 ? 4 : (code.rt->iv * 4); // TODO
     }
     dist -= size;
-    runtime.push(LOC(code.rd->sv, dist));
+    if (!code.rd->slot.placed()) {
+        code.rd->slot = pl0_slot_t(depth, dist); // a temporary copy, the variables are laid out by the resolver.
+    }
     return string("    sub esp, ") + to_string(size) + "\t\t;; " + code.str();
 }
 
 static void pl0_x86_gen_header(BasicBlock & bb, std::vector<std::string> & buffer) {
-    runtime.tag(); old.emplace_back(dist); dist = 0;
-    size_t p = pl0_x86_gen_param(bb.code, 0);
+    old.emplace_back(dist); dist = 0; depth = depth + 1;
+    std::vector<std::string> layout;
+    size_t p = pl0_x86_gen_param(bb.code, layout, 0);
     buffer.emplace_back(string(""));
-    buffer.emplace_back(string("    global ") + bb.code[p].rd->sv);
-    buffer.emplace_back(string(bb.code[p].rd->sv) + ":");
+    buffer.emplace_back(string("    global ") + bb.code[p].rd->sv.str());
+    buffer.emplace_back(bb.code[p].rd->sv.str() + ":");
     buffer.emplace_back(string("    push ebp"));
     buffer.emplace_back(string("    mov ebp, esp"));
     // prepare displays.
-    int d = runtime.depth();
-    runtime.push(LOC(string("$fn") + bb.code[p].rd->sv, d));
     buffer.emplace_back("    mov ebx, dword [ebp]");
-    for (int i = 1; i < d; ++i) {
+    for (int i = 1; i < depth; ++i) {
         buffer.emplace_back("    push dword [ebx-" + to_string(i*4) + "]");
     }
-    dist = dist - 4 * d;
+    dist = dist - 4 * depth;
     buffer.emplace_back("    push ebp");
-    if (++p < bb.size() && bb.code[p].op == "allocret") {
+    if (++p < bb.size() && bb.code[p].op == TAC::ALLOCRET) {
         dist = dist - 4;
-        runtime.push(LOC(bb.code[p].rd->sv, dist));
+        bb.code[p].rd->slot = pl0_slot_t(depth, dist);
         buffer.emplace_back(string("    sub esp, ") + to_string(4) + "\t\t;; " + bb.code[p].str());
         p = p + 1;
     }
-    while (p < bb.size() && bb.code[p].op == "def") {
-        buffer.emplace_back(x86_gen_def(bb.code[p++]));
+    while (p < bb.size() && bb.code[p].op == TAC::DEF) {
+        buffer.emplace_back(x86_gen_def(bb.code[p]));
+        layout.emplace_back(pl0_x86_slot(bb.code[p++].rd));
+    }
+    cout << ";; -----------------  Frame Layout  -------------------" << endl;
+    for (auto && l: layout) {
+        cout << ";; " << l << endl;
     }
+    cout << ";; -----------------------------------------------------" << endl;
+}
+
+// the instruction of a jump.
+static char const *pl0_x86_jump(TAC::cond_t cc) {
+    static char const * const jumps[] = { "jmp", "jl", "jle", "jg", "jge", "je", "jne" };
+    return jumps[cc];
 }
 
 static void pl0_x86_gen_common(TAC & c) {
-    if (c.op == "endproc" || c.op == "endfunc") {
-        manager.release("eax", true);
-        manager.spillAll();
-        out.emit(string("    leave"));
-        out.emit(string("    ret"), c);
-        runtime.detag();
-        old.pop_back(); dist = old.back(); old.pop_back();
-    }
-    else if (c.op == "=") {
-        std::string rs, rd = manager.alloc(c.rd->sv);
-        if (c.rs->t == Value::TYPE::IMM) {
-            rs = c.rs->value();
-        }
-        else {
-            rs = manager.locate(c.rs->sv);
-        }
-        out.emit(string("    mov ") + rd + ", " + rs, c);
-        // if (c.rd->dt == "char") {
-        //     out.emit(string("    and ") + rd + ", 0x000000ff");
-        // }
-        manager.spill(rd);
-    }
-    else if (c.op == "[]=") {
-        std::string rs = "edi", rt = "esi", rd;
-        if (c.rs->t == Value::TYPE::IMM) {
-            rs = c.rs->value();
-        }
-        else {
-            rs = manager.load(c.rs->sv, "edi");
-        }
-        if (c.rt->t == Value::TYPE::IMM) {
-            rt = c.rt->value();
-        }
-        else {
-            rt = manager.load(c.rt->sv, "esi");
-        }
-        rd = manager.locate(c.rd->sv);
-        if (rd.length() >= 3 && rd.substr(0, 3) == "dwo") {
-            rd = rd.substr(0, rd.length()-1) + "+4*" + rs + "]";
-        }
-        else {
-            rd = string("dword [") + rd + "+4*" + rs + "]"; 
-        }
-        out.emit(string("    mov ") + rd + ", " + rt, c);
-    }
-    else if (c.op == "=[]") {
-        std::string rt = "edi", rs, rd = manager.load(c.rd->sv, "esi");
-        if (c.rt->t == Value::TYPE::IMM) {
-            rt = c.rt->value();
-        }
-        else {
-            rt = manager.load(c.rt->sv, "edi");
-        }
-        rs = manager.locate(c.rs->sv);
-        if (rs.length() >= 3 && rs.substr(0, 3) == "dwo") {
-            rs = rs.substr(0, rs.length()-1) + "+4*" + rt + "]";
-        }
-        else {
-            rs = string("dword [") + rs + "+4*" + rt + "]";
-        }
-        out.emit(string("    mov ") + rd + ", " + rs, c);
-        manager.spill(rd);
-    }
-    else if (c.op == "loadret") {
-        manager.spillAll();
-        out.emit("    mov eax, dword [ebp-" + to_string(runtime.depth()*4+4) + "]", c);
-    }
-    else if (c.op == "exit") {
-        out.emit(string("    mov eax, ") + c.rd->value(), c);
-    }
-    else if (c.op == "call") {
-        manager.spillAll();
-        for (auto && a: c.args) { // push
-            if (a.second) { // call by reference
-                if (a.first->sv.back() == '#') {
-                    // array element.
-                    std::string t = a.first->sv, array, idx;
-                    t = t.substr(0, t.length()-1);
-                    int p = t.rfind('#');
-                    idx = t.substr(p+1);
-                    t = t.substr(0, p);
-                    p = t.rfind('#');
-                    if (idx.front() >= '0' && idx.front() <= '9') {
-                        out.emit(string("    mov edi, ") + idx);
+    switch (c.op) {
+        case TAC::ENDPROC: case TAC::ENDFUNC: {
+            manager.release("eax");
+            manager.spillAll();
+            out.emit(string("    leave"));
+            out.emit(string("    ret"), c);
+            depth = depth - 1;
+            old.pop_back(); dist = old.back(); old.pop_back();
+            break;
+        }
+        case TAC::ASSIGN: {
+            std::string rs, rd = manager.alloc(c.rd);
+            if (c.rs->t == Value::IMM) {
+                rs = c.rs->value();
+            }
+            else {
+                rs = manager.locate(c.rs);
+            }
+            out.emit(string("    mov ") + rd + ", " + rs, c);
+            // if (c.rd->dt == pl0_type_t::CHAR) {
+            //     out.emit(string("    and ") + rd + ", 0x000000ff");
+            // }
+            manager.spill(rd);
+            break;
+        }
+        case TAC::STORE_ELEM: {
+            std::string rs = "edi", rt = "esi", rd;
+            if (c.rs->t == Value::IMM) {
+                rs = c.rs->value();
+            }
+            else {
+                rs = manager.load(c.rs, "edi");
+            }
+            if (c.rt->t == Value::IMM) {
+                rt = c.rt->value();
+            }
+            else {
+                rt = manager.load(c.rt, "esi");
+            }
+            rd = "dword " + manager.elem(c.rd, rs);
+            out.emit(string("    mov ") + rd + ", " + rt, c);
+            break;
+        }
+        case TAC::LOAD_ELEM: {
+            std::string rt = "edi", rs, rd = manager.load(c.rd, "esi");
+            if (c.rt->t == Value::IMM) {
+                rt = c.rt->value();
+            }
+            else {
+                rt = manager.load(c.rt, "edi");
+            }
+            rs = "dword " + manager.elem(c.rs, rt);
+            out.emit(string("    mov ") + rd + ", " + rs, c);
+            manager.spill(rd);
+            break;
+        }
+        case TAC::LOADRET: {
+            manager.spillAll();
+            out.emit("    mov eax, dword [ebp-" + to_string(depth*4+4) + "]", c);
+            break;
+        }
+        case TAC::EXIT: {
+            out.emit(string("    mov eax, ") + c.rd->value(), c);
+            break;
+        }
+        case TAC::CALL: {
+            manager.spillAll();
+            for (auto && a: c.args) { // push
+                if (a.second) { // call by reference
+                    if (a.first->t == Value::ELEM) {
+                        // array element.
+                        if (a.first->idx->t == Value::IMM) {
+                            out.emit(string("    mov edi, ") + a.first->idx->value(), c);
+                        }
+                        else {
+                            manager.load(a.first->idx, "edi");
+                            manager.release("edi");
+                        }
+                        out.emit(string("    lea ebx, ") + manager.elem(a.first->base, "edi"), c);
+                        out.emit(string("    push ebx"), c);
                     }
                     else {
-                        manager.load(idx, "edi");
-                        manager.release("edi", true);
+                        manager.store(a.first);
+                        out.emit(string("    lea ebx, ") + manager.addr(a.first), c);
+                        out.emit(string("    push ebx"), c);
                     }
-                    array = manager.locate(t.substr(p+1));
-                    if (array.length() >= 3 && array.substr(0, 3) == "dwo") {
-                        array = array.substr(6, array.length()-7) + "+4*edi]";
+                }
+                else { // call by value.
+                    if (a.first->t == Value::IMM) {
+                        out.emit(string("    push ") + a.first->value());
                     }
-                    else {
-                        array = string("[") + array + "+4*" + idx + "]"; 
+                    else if (manager.exist(a.first).length() == 0) {
+                        out.emit(string("    push ") + manager.locate(a.first));
                     }
-                    out.emit(string("    lea ebx, ") + array);
-                    out.emit(string("    push ebx"), c);
                 }
-                else {
-                    manager.store(a.first->sv);
-                    out.emit(string("    lea ebx, ") + manager.addr(a.first->sv));
-                    out.emit(string("    push ebx"));
+            }
+            out.emit("    call " + c.rd->sv.str(), c);
+            if (c.rt) { // for function call, load return value.
+                manager.remap("eax", c.rt);
+            }
+            if (c.args.size() > 0) { // pop
+                out.emit("    add esp, " + to_string(c.args.size() * 4));
+            }
+            // at the end of function call, merge two frame, so, don't restore $esp value.
+            break;
+        }
+        case TAC::READ: {
+            manager.spillAll();
+            manager.store(c.rd);
+            out.emit(string("    lea ebx, ") + manager.addr(c.rd));
+            out.emit(string("    push dword ebx"));
+            if (c.rd->dt == pl0_type_t::INTEGER) {
+                out.emit(string("    push dword __fin_int"));
+            }
+            else {
+                out.emit(string("    push dword __fin_char"));
+            }
+            out.emit(string("    call _scanf"), c);
+            out.emit(string("    add esp, 8\t\t;; pop stack at once."));
+            break;
+        }
+        case TAC::WRITE_E: {
+            manager.spillAll();
+            if (c.rd->t == Value::IMM) {
+                out.emit(string("    push ") + c.rd->value());
+            }
+            else {
+                out.emit(string("    push ") + manager.locate(c.rd));
+            }
+            if (c.rd->dt == pl0_type_t::INTEGER) {
+                out.emit(string("    push dword __fout_int"));
+            }
+            else {
+                out.emit(string("    push dword __fout_char"));
+            }
+            out.emit(string("    call    _printf"), c);
+            out.emit(string("    add esp, 8\t\t;; pop stack at once."));
+            break;
+        }
+        case TAC::WRITE_S: {
+            manager.spillAll();
+            asciis.emplace_back(make_pair(c.rd->str(), c.rs->value()));
+            out.emit(string("    push dword __L") + c.rs->value());
+            out.emit(string("    push dword __fout_string"));
+            out.emit(string("    call    _printf"), c);
+            out.emit(string("    add esp, 8\t\t;; pop stack at once."));
+            break;
+        }
+        case TAC::ADD: {
+            Value *rd = c.rd, *rs = c.rs, *rt = c.rt;
+            std::string dest = manager.load(rd);
+            if (c.rs->t == Value::IMM && c.rt->t == Value::IMM) {
+                out.emit(string("    mov ") + dest + ", " + c.rs->value());
+                out.emit(string("    add ") + dest + ", " + c.rt->value(), c);
+            }
+            else if (c.rs->t == Value::IMM) {
+                if (!manager.alias(rd, rt)) {
+                    out.emit(string("    mov ") + dest + ", " + manager.locate(rt));
                 }
+                out.emit(string("    add ") + dest + ", " + c.rs->value(), c);
             }
-            else { // call by value.
-                if (a.first->t == Value::TYPE::IMM) {
-                    out.emit(string("    push ") + a.first->value());
+            else if (c.rt->t == Value::IMM) {
+                if (!manager.alias(rd, rs)) {
+                    out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
+                }
+                out.emit(string("    add ") + dest + ", " + c.rt->value(), c);
+            }
+            else {
+                if (!manager.alias(rd, rs) && !manager.alias(rd, rt)) {
+                    out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
                 }
-                else if (manager.exist(a.first->sv).length() == 0) {
-                    out.emit(string("    push ") + manager.locate(a.first->sv));
+                if (manager.alias(rd, rt)) {
+                    out.emit(string("    add ") + dest + ", " + manager.locate(rs), c);
                 }
+                else {
+                    out.emit(string("    add ") + dest + ", " + manager.locate(rt), c);
+                }                
             }
+            break;
         }
-        out.emit("    call " + c.rd->sv, c);
-        if (c.rt) { // for function call, load return value.
-            manager.remap("eax", c.rt->sv);
-        }
-        if (c.args.size() > 0) { // pop
-            out.emit("    add esp, " + to_string(c.args.size() * 4));
-        }
-        // at the end of function call, merge two frame, so, don't restore $esp value.
-    }
-    else if (c.op == "read") {
-        manager.spillAll();
-        manager.store(c.rd->sv);
-        out.emit(string("    lea ebx, ") + manager.addr(c.rd->sv));
-        out.emit(string("    push dword ebx"));
-        if (c.rd->dt == "integer") {
-            out.emit(string("    push dword __fin_int"));
-        }
-        else {
-            out.emit(string("    push dword __fin_char"));
-        }
-        out.emit(string("    call _scanf"), c);
-        out.emit(string("    add esp, 8\t\t;; pop stack at once."));
-    }
-    else if (c.op == "write_e") {
-        manager.spillAll();
-        if (c.rd->t == Value::TYPE::IMM) {
-            out.emit(string("    push ") + c.rd->value());
-        }
-        else {
-            out.emit(string("    push ") + manager.locate(c.rd->sv));
-        }
-        if (c.rd->dt == "integer") {
-            out.emit(string("    push dword __fout_int"));
-        }
-        else {
-            out.emit(string("    push dword __fout_char"));
-        }
-        out.emit(string("    call    _printf"), c);
-        out.emit(string("    add esp, 8\t\t;; pop stack at once."));
-    }
-    else if (c.op == "write_s") {
-        manager.spillAll();
-        asciis.emplace_back(make_pair(c.rd->sv, c.rs->value()));
-        out.emit(string("    push dword __L") + c.rs->value());
-        out.emit(string("    push dword __fout_string"));
-        out.emit(string("    call    _printf"), c);
-        out.emit(string("    add esp, 8\t\t;; pop stack at once."));
-    }
-    else if (c.op == "+") {
-        std::string rd = c.rd->sv, rs = c.rs->value(), rt = c.rt->value();
-        std::string dest = manager.load(rd);
-        if (c.rs->t == Value::TYPE::IMM && c.rt->t == Value::TYPE::IMM) {
-            out.emit(string("    mov ") + dest + ", " + rs);
-            out.emit(string("    add ") + dest + ", " + rt, c);
-        }
-        else if (c.rs->t == Value::TYPE::IMM) {
-            if (rd != rt) {
-                out.emit(string("    mov ") + dest + ", " + manager.locate(rt));
+        case TAC::SUB: {
+            Value *rd = c.rd, *rs = c.rs, *rt = c.rt;
+            std::string dest = manager.load(rd);
+            if (c.rs == c.rt) {
+                out.emit(string("    mov ") + dest + ", 0", c);
             }
-            out.emit(string("    add ") + dest + ", " + rs, c);
-        }
-        else if (c.rt->t == Value::TYPE::IMM) {
-            if (rd != rs) {
-                out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
+            else if (c.rs->t == Value::IMM && c.rt->t == Value::IMM) {
+                out.emit(string("    mov ") + dest + ", " + c.rs->value());
+                out.emit(string("    sub ") + dest + ", " + c.rt->value(), c);
             }
-            out.emit(string("    add ") + dest + ", " + rt, c);
-        }
-        else {
-            if (rd != rs && rd != rt) {
-                out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
+            else if (c.rs->t == Value::IMM) {
+                if (manager.alias(rd, rt)) {
+                    out.emit(string("    neg ") + dest);
+                    out.emit(string("    add ") + dest + ", " + c.rs->value(), c);
+                }
+                else {
+                    out.emit(string("    mov ") + dest + ", " + c.rs->value());
+                    out.emit(string("    sub ") + dest + ", " + manager.locate(rt), c);
+                }
             }
-            if (rd == rt) {
-                out.emit(string("    add ") + dest + ", " + manager.locate(rs), c);
+            else if (c.rt->t == Value::IMM) {
+                if (!manager.alias(rd, rs)) {
+                    out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
+                }
+                out.emit(string("    sub ") + dest + ", " + c.rt->value(), c);
             }
             else {
-                out.emit(string("    add ") + dest + ", " + manager.locate(rt), c);
-            }                
-        }
-    }
-    else if (c.op == "-") {
-        std::string rd = c.rd->sv, rs = c.rs->value(), rt = c.rt->value();
-        std::string dest = manager.load(rd);
-        if (rs == rt) {
-            out.emit(string("    mov ") + dest + ", 0", c);
-        }
-        else if (c.rs->t == Value::TYPE::IMM && c.rt->t == Value::TYPE::IMM) {
-            out.emit(string("    mov ") + dest + ", " + rs);
-            out.emit(string("    sub ") + dest + ", " + rt, c);
+                if (manager.alias(rd, rt)) {
+                    out.emit(string("    neg ") + dest);
+                    out.emit(string("    add ") + dest + ", " + manager.locate(rs), c);
+                }
+                else {
+                    if (!manager.alias(rd, rs)) {
+                        out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
+                    }
+                    out.emit(string("    sub ") + dest + ", " + manager.locate(rt), c);
+                }
+            }
+            break;
         }
-        else if (c.rs->t == Value::TYPE::IMM) {
-            if (rd == rt) {
-                out.emit(string("    neg ") + dest);
-                out.emit(string("    add ") + dest + ", " + rs, c);
+        case TAC::MUL: {
+            manager.spill("eax");
+            manager.spill("edx");
+            if (c.rs->t == Value::IMM) {
+                out.emit(string("    mov eax, ") + c.rs->value());
             }
             else {
-                out.emit(string("    mov ") + dest + ", " + rs);
-                out.emit(string("    sub ") + dest + ", " + manager.locate(rt), c);
+                out.emit(string("    mov eax, ") + manager.locate(c.rs));
             }
-        }
-        else if (c.rt->t == Value::TYPE::IMM) {
-            if (rd != rs) {
-                out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
+            if (c.rt->t == Value::IMM) {
+                out.emit(string("    mov edx, ") + c.rt->value());
             }
-            out.emit(string("    sub ") + dest + ", " + rt, c);
-        }
-        else {
-            if (rd == rt) {
-                out.emit(string("    neg ") + dest);
-                out.emit(string("    add ") + dest + ", " + manager.locate(rs), c);
+            else {
+                out.emit(string("    mov edx, ") + manager.locate(c.rt));
+            }
+            out.emit(string("    imul edx"), c);
+            manager.remap("eax", c.rd);
+            break;
+        }
+        case TAC::DIV: {
+            manager.spill("eax");
+            manager.spill("ecx");
+            manager.spill("edx");
+            out.emit(string("    mov edx, 0"));
+            std::string rt = "ecx";
+            if (c.rs->t == Value::IMM) {
+                out.emit(string("    mov eax, ") + c.rs->value());
             }
             else {
-                if (rd != rs) {
-                    out.emit(string("    mov ") + dest + ", " + manager.locate(rs));
-                }
-                out.emit(string("    sub ") + dest + ", " + manager.locate(rt), c);
+                out.emit(string("    mov eax, ") + manager.locate(c.rs));
             }
+            if (c.rt->t == Value::IMM) {
+                out.emit(string("    mov ecx, ") + c.rt->value());
+            }
+            else {
+                manager.load(c.rt, "ecx");
+            }
+            out.emit("    cdq");
+            out.emit("    idiv " + rt, c);
+            manager.remap("eax", c.rd);
+            break;
+        }
+        case TAC::MOD: {
+            manager.spill("eax");
+            manager.spill("ecx");
+            manager.spill("edx");
+            out.emit(string("    mov edx, 0"));
+            std::string rt = "ecx";
+            if (c.rs->t == Value::IMM) {
+                out.emit(string("    mov eax, ") + c.rs->value());
+            }
+            else {
+                out.emit(string("    mov eax, ") + manager.locate(c.rs));
+            }
+            if (c.rt->t == Value::IMM) {
+                out.emit(string("    mov ecx, ") + c.rt->value());
+            }
+            else {
+                manager.load(c.rt, "ecx");
+            }
+            out.emit(string("    cdq")); // Convert double-word to quad-word
+            out.emit(string("    idiv ") + rt, c);
+            manager.remap("edx", c.rd);
+            break;
+        }
+        case TAC::CMP: {
+            manager.spillAll();
+            std::string comp, rs = "esi", rt = "edi";
+            if (c.rs->t == Value::IMM) {
+                out.emit("    mov esi, " + c.rs->value());
+            }
+            else {
+                manager.load(c.rs, "esi");
+                manager.release("esi");
+            }
+            if (c.rt->t == Value::IMM) {
+                out.emit("    mov edi, " + c.rt->value());
+            }
+            else {
+                manager.load(c.rt, "edi");
+                manager.release("edi");
+            }
+            comp = string("    cmp esi, edi");
+            if (old.back() - dist > 0) {
+                out.emit(string("    add esp, ") + to_string(old.back() - dist));
+                dist = old.back();
+            }
+            out.emit(comp, c);
+            break;
         }
-    }
-    else if (c.op == "*") {
-        manager.spill("eax");
-        manager.spill("edx");
-        if (c.rs->t == Value::TYPE::IMM) {
-            out.emit(string("    mov eax, ") + c.rs->value());
-        }
-        else {
-            out.emit(string("    mov eax, ") + manager.locate(c.rs->sv));
-        }
-        if (c.rt->t == Value::TYPE::IMM) {
-            out.emit(string("    mov edx, ") + c.rt->value());
-        }
-        else {
-            out.emit(string("    mov edx, ") + manager.locate(c.rt->sv));
-        }
-        out.emit(string("    imul edx"), c);
-        manager.remap("eax", c.rd->sv);
-    }
-    else if (c.op == "/") {
-        manager.spill("eax");
-        manager.spill("ecx");
-        manager.spill("edx");
-        out.emit(string("    mov edx, 0"));
-        std::string rt = "ecx";
-        if (c.rs->t == Value::TYPE::IMM) {
-            out.emit(string("    mov eax, ") + c.rs->value());
-        }
-        else {
-            out.emit(string("    mov eax, ") + manager.locate(c.rs->sv));
-        }
-        if (c.rt->t == Value::TYPE::IMM) {
-            out.emit(string("    mov ecx, ") + c.rt->value());
-        }
-        else {
-            manager.load(c.rt->sv, "ecx");
-        }
-        out.emit("    cdq");
-        out.emit("    idiv " + rt, c);
-        manager.remap("eax", c.rd->sv);
-    }
-    else if (c.op == "%") {
-        manager.spill("eax");
-        manager.spill("ecx");
-        manager.spill("edx");
-        out.emit(string("    mov edx, 0"));
-        std::string rt = "ecx";
-        if (c.rs->t == Value::TYPE::IMM) {
-            out.emit(string("    mov eax, ") + c.rs->value());
-        }
-        else {
-            out.emit(string("    mov eax, ") + manager.locate(c.rs->sv));
-        }
-        if (c.rt->t == Value::TYPE::IMM) {
-            out.emit(string("    mov ecx, ") + c.rt->value());
-        }
-        else {
-            manager.load(c.rt->sv, "ecx");
-        }
-        out.emit(string("    cdq")); // Convert double-word to quad-word
-        out.emit(string("    idiv ") + rt, c);
-        manager.remap("edx", c.rd->sv);
-    }
-    else if (c.op == "cmp") {
-        manager.spillAll();
-        std::string comp, rs = "esi", rt = "edi";
-        if (c.rs->t == Value::TYPE::IMM) {
-            out.emit("    mov esi, " + c.rs->value());
-        }
-        else {
-            manager.load(c.rs->sv, "esi");
-            manager.release("esi", true);
-        }
-        if (c.rt->t == Value::TYPE::IMM) {
-            out.emit("    mov edi, " + c.rt->value());
-        }
-        else {
-            manager.load(c.rt->sv, "edi");
-            manager.release("edi", true);
-        }
-        comp = string("    cmp esi, edi");
-        if (old.back() - dist > 0) {
-            out.emit(string("    add esp, ") + to_string(old.back() - dist));
-            dist = old.back();
-        }
-        out.emit(comp, c);
-    }
-    else if (c.op == "label") {
-        out.emit(string("__L") + c.rd->value() + ":");
-        if (c.rs == nullptr) {
-            old.emplace_back(dist);
-        }
-        else {
-            // cout << ";; merge scope." << endl;
+        case TAC::LABEL: {
+            out.emit(string("__L") + c.rd->value() + ":");
+            if (c.rs == nullptr) {
+                old.emplace_back(dist);
+            }
+            else {
+                // cout << ";; merge scope." << endl;
+            }
+            break;
         }
-    }
-    else if (c.op == "goto") {
-        manager.spillAll();
-        if (old.back() - dist > 0) {
-            out.emit(string("    add esp, ") + to_string(old.back() - dist));
+        case TAC::GOTO: {
+            manager.spillAll();
+            if (old.back() - dist > 0) {
+                out.emit(string("    add esp, ") + to_string(old.back() - dist));
+            }
+            dist = old.back(); old.pop_back();
+            out.emit(string("    ") + pl0_x86_jump(c.cc) + " __L" + c.rd->value(), c);
+            break;
         }
-        dist = old.back(); old.pop_back();
-        out.emit(string("    ") + c.rd->sv + " __L" + c.rs->value(), c);
-    }
-    else {
-        out.emit("UNIMPLEMENT", c);
+        default:
+            out.emit("UNIMPLEMENT", c);
+            break;
     }
 }
 
+// location of the TAC being translated, for the errors thrown by the code generator.
+pl0_loc_t pl0_x86_loc = 0;
+
 static void pl0_x86_gen_body(BasicBlock & bb) {
     for (auto && c: bb.code) {
+        pl0_x86_loc = c.loc;
         pl0_x86_gen_common(c);
     }
 }
@@ -408,7 +426,6 @@ static void pl0_x86_gen_body(BasicBlock & bb) {
 static size_t pl0_x86_gen_blocks(std::vector<BasicBlock> & bbs, size_t bp = 0) {
     std::vector<std::string> buffer;
     pl0_x86_gen_header(bbs[bp++], buffer);
-    runtime.dump();
     while (bp < bbs.size() && bbs[bp].no == 0) {
         bp = pl0_x86_gen_blocks(bbs, bp);
     }
@@ -19,32 +19,39 @@ class RegisterAllocator
 {
 protected:
     static const int N = 5 /* 6 */;
-    pl0_env<LOC> & env;
     struct IOOut & out;
     int & dist;
+    int & depth; // static depth of the frame being generated.
     // %eax, %ecx, %edx, %ebx, %esi, %edi
     std::string regs[N] = {"eax", "ecx", "edx", /* "ebx", */ "esi", "edi"};
     std::map<std::string, bool> used;
-    std::map<std::string, std::string> record;
+    std::map<std::string, Value *> record; // register -> variable.
 public:
-    RegisterAllocator(pl0_env<LOC> &, struct IOOut &, int &);
-    virtual std::string alloc(std::string, bool is_ref = true) = 0;
-    virtual void remap(std::string, std::string) = 0;
-    virtual void release(std::string, bool) = 0;
-    virtual std::string load(std::string) = 0;
-    virtual std::string load(std::string, std::string) = 0;
+    RegisterAllocator(struct IOOut &, int &, int &);
+    virtual std::string alloc(Value *, bool is_ref = true) = 0;
+    virtual void remap(std::string, Value *) = 0;
+    virtual void release(std::string) = 0;
+    virtual void release(Value *) = 0;
+    virtual std::string load(Value *) = 0;
+    virtual std::string load(Value *, std::string) = 0;
     virtual void spill(std::string) = 0;
     virtual void spillAll() = 0;
-    virtual void store(std::string) = 0;
-    virtual std::string locate(std::string) = 0;
-    virtual std::string addr(std::string) = 0;
+    virtual void store(Value *) = 0;
+    virtual std::string locate(Value *) = 0;
+    virtual std::string addr(Value *) = 0;
+    virtual std::string elem(Value *, std::string) = 0;
     int random() {
         std::srand(std::time(0));
         return std::rand() % N;
     }
-    string exist(std::string name) {
+    // whether two operands are the same storage: the same operand, or a variable at the same slot (the variable
+    // retyped by a cast).
+    static bool alias(Value const *a, Value const *b) {
+        return a == b || (a && b && a->t == Value::STR && b->t == Value::STR && a->slot.placed() && a->slot == b->slot);
+    }
+    string exist(Value *name) {
         for (auto && x: record) {
-            if (x.second == name) {
+            if (alias(x.second, name)) {
                 return x.first;
             }
         }
@@ -53,7 +60,7 @@ public:
     void dump() {
         cout << ";; ------------ register mapping ----------------" << endl;
         for (auto && x: record) {
-            cout << ";; "<< x.first << " : " << x.second << endl;
+            cout << ";; "<< x.first << " : " << x.second->str() << endl;
         }
         cout << ";; ----------------------------------------------" << endl;
     }
@@ -61,17 +68,21 @@ public:
 
 class SimpleAllocator: public RegisterAllocator {
 public:
-    SimpleAllocator(pl0_env<LOC> &, struct IOOut &, int &);
-    std::string alloc(std::string, bool is_ref = true);
-    void remap(std::string, std::string);
-    void release(std::string, bool);
-    std::string load(std::string);
-    std::string load(std::string, std::string);
+    SimpleAllocator(struct IOOut &, int &, int &);
+    std::string alloc(Value *, bool is_ref = true);
+    void remap(std::string, Value *);
+    void release(std::string);
+    void release(Value *);
+    std::string load(Value *);
+    std::string load(Value *, std::string);
     void spill(std::string);
     void spillAll();
-    void store(std::string);
-    std::string locate(std::string);
-    std::string addr(std::string);
+    void store(Value *);
+    std::string locate(Value *);
+    std::string addr(Value *);
+    std::string elem(Value *, std::string);
+private:
+    std::pair<std::string, int> base(Value *);
 };
 
 #endif /* __PL0_X86_H__ */
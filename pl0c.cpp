@@ -6,21 +6,24 @@
 #include "parse_tool.hpp"
 
 #include "pl0_ast.hpp"
+#include "pl0_lexer.hpp"
 #include "pl0_opt.h"
 
 using namespace std;
 
-extern parser_t<pl0_ast_program *> pl0_program;
+extern pl0_parser_t<pl0_ast_program *> pl0_program;
 extern struct IRBuilder irb;
+void pl0_resolve_program(pl0_ast_program const *program);
 bool pl0_tac_program(pl0_ast_program const *program);
 void pl0_x86_gen(std::string file, std::vector<BasicBlock> & bbs);
+extern pl0_loc_t pl0_x86_loc;
 
 bool verbose = true;
 
-input_t *load_case(char const *fname) {
+input_t load_case(char const *fname) {
     std::ifstream t(fname);
     std::string str((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
-    return new input_t(str);
+    return input_t(str, 1, 1, fname);
 }
 
 int main(int argc, char **argv) {
@@ -32,8 +35,12 @@ int main(int argc, char **argv) {
         opt = false;
     }
     auto parse_tool = ParsecT<decltype(pl0_program)>(pl0_program);
-    input_t *in = load_case(argv[1]);
+    input_t in = load_case(argv[1]);
+    pl0_source(in);
     auto res = parse_tool(in);
+    for (auto && diag: res.diagnostics) {
+        cout << diag.loc.first << ":" << diag.loc.second << " ERROR: " << diag.message << endl;
+    }
     if (!res.status) {
         cout << "Errors occurred during parsing." << endl;
         return 0;
@@ -42,9 +49,11 @@ int main(int argc, char **argv) {
         cout << "Extra characters in source text." << endl;
     }
 
+    pl0_resolve_program(res.actual);
     if (!pl0_tac_program(res.actual)) {
         cout << "Errors occurred during semantic analysing." << endl;
     }
+    pl0_arena.release(); // the TAC doesn't refer to the tree.
 
     cout << "\n;; <<<<<<<<<<<<<  All Basic Blocks <<<<<<<<<<<<<<<<<<<<<<<<<<<\n" << endl;
 
@@ -64,11 +73,14 @@ int main(int argc, char **argv) {
     try { // try exception throwed during assembly code generating.
         pl0_x86_gen(string(argv[1]), bbs);
     } catch (std::exception & e) {
-        cout << string(";; !!!Exception: ") + string(e.what()) << endl;
+        pair<int, int> loc = pl0_locate(pl0_x86_loc);
+        cout << string(";; !!!Exception: ") + to_string(loc.first) + ":" + to_string(loc.second) + " " + string(e.what()) << endl;
     } catch (...) {
-        cout << string(";; !!!Exception: ") + "unknown exception." << endl;
+        pair<int, int> loc = pl0_locate(pl0_x86_loc);
+        cout << string(";; !!!Exception: ") + to_string(loc.first) + ":" + to_string(loc.second) + " " + "unknown exception." << endl;
     }
-    
+    pl0_values.release(); // all operands of the TAC.
+
     return 0;
 }
 
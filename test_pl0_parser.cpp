@@ -8,53 +8,55 @@
 #include "parse_tool.hpp"
 
 #include "pl0_ast.hpp"
+#include "pl0_lexer.hpp"
 
 using namespace std;
 
-extern parser_t<pl0_ast_program *> pl0_program;
-extern parser_t<pl0_ast_prog *> pl0_prog;
-extern parser_t<pl0_ast_const_stmt *> pl0_const_stmt;
-extern parser_t<pl0_ast_const_define *> pl0_const_define;
-extern parser_t<pl0_ast_constv *> pl0_const;
-extern parser_t<pl0_ast_constv *> pl0_char;
-extern parser_t<pl0_ast_charseq *> pl0_charseq;
-extern parser_t<pl0_ast_constv *> pl0_unsigned;
-extern parser_t<pl0_ast_identify *> pl0_identify;
-extern parser_t<pl0_ast_var_stmt *> pl0_var_stmt;
-extern parser_t<pl0_ast_var_define *> pl0_var_define;
-extern parser_t<pl0_ast_type *> pl0_type;
-extern parser_t<pl0_ast_primitive_type *> pl0_primitive_type;
-extern parser_t<pl0_ast_executable *> pl0_executable;
-extern parser_t<pl0_ast_procedure_stmt *> pl0_procedure_stmt;
-extern parser_t<pl0_ast_function_stmt *> pl0_function_stmt;
-extern parser_t<pl0_ast_procedure_header *> pl0_procedure_header;
-extern parser_t<pl0_ast_function_header *> pl0_function_header;
-extern parser_t<pl0_ast_param_list *> pl0_param_list;
-extern parser_t<pl0_ast_param_group *> pl0_param_group;
-extern parser_t<pl0_ast_stmt *> pl0_stmt;
-extern parser_t<pl0_ast_null_stmt *> pl0_null_stmt; // empty statement, not in grammar.
-extern parser_t<pl0_ast_assign_stmt *> pl0_assign_stmt;
-extern parser_t<pl0_ast_function_id *> pl0_function_id;
-extern parser_t<pl0_ast_expression *> pl0_expression;
-extern parser_t<pl0_ast_term *> pl0_term;
-extern parser_t<pl0_ast_factor *> pl0_factor;
-extern parser_t<pl0_ast_call_func *> pl0_call_func;
-extern parser_t<pl0_ast_arg_list *> pl0_arg_list;
-extern parser_t<pl0_ast_arg *> pl0_arg;
-extern parser_t<pl0_ast_addop *> pl0_addop;
-extern parser_t<pl0_ast_multop *> pl0_multop;
-extern parser_t<pl0_ast_condtion *> pl0_condition;
-extern parser_t<pl0_ast_comp_op *> pl0_comp_op;
-extern parser_t<pl0_ast_cond_stmt *> pl0_cond_stmt;
-extern parser_t<pl0_ast_case_stmt *> pl0_case_stmt;
-extern parser_t<pl0_ast_case_term *> pl0_case_term;
-extern parser_t<pl0_ast_for_stmt *> pl0_for_stmt;
-extern parser_t<pl0_ast_call_proc *> pl0_call_proc;
-extern parser_t<pl0_ast_compound_stmt *> pl0_compound_stmt;
-extern parser_t<pl0_ast_read_stmt *> pl0_read_stmt;
-extern parser_t<pl0_ast_write_stmt *> pl0_write_stmt;
+extern pl0_parser_t<pl0_ast_program *> pl0_program;
+extern pl0_parser_t<pl0_ast_prog *> pl0_prog;
+extern pl0_parser_t<pl0_ast_const_stmt *> pl0_const_stmt;
+extern pl0_parser_t<pl0_ast_const_define *> pl0_const_define;
+extern pl0_parser_t<pl0_ast_constv *> pl0_const;
+extern pl0_parser_t<pl0_ast_constv *> pl0_char;
+extern pl0_parser_t<pl0_ast_charseq *> pl0_charseq;
+extern pl0_parser_t<pl0_ast_constv *> pl0_unsigned;
+extern pl0_parser_t<pl0_ast_identify *> pl0_identify;
+extern pl0_parser_t<pl0_ast_var_stmt *> pl0_var_stmt;
+extern pl0_parser_t<pl0_ast_var_define *> pl0_var_define;
+extern pl0_parser_t<pl0_ast_type *> pl0_type;
+extern pl0_parser_t<pl0_ast_primitive_type *> pl0_primitive_type;
+extern pl0_parser_t<pl0_ast_executable *> pl0_executable;
+extern pl0_parser_t<pl0_ast_procedure_stmt *> pl0_procedure_stmt;
+extern pl0_parser_t<pl0_ast_function_stmt *> pl0_function_stmt;
+extern pl0_parser_t<pl0_ast_procedure_header *> pl0_procedure_header;
+extern pl0_parser_t<pl0_ast_function_header *> pl0_function_header;
+extern pl0_parser_t<pl0_ast_param_list *> pl0_param_list;
+extern pl0_parser_t<pl0_ast_param_group *> pl0_param_group;
+extern pl0_parser_t<pl0_ast_stmt *> pl0_stmt;
+extern pl0_parser_t<pl0_ast_null_stmt *> pl0_null_stmt; // empty statement, not in grammar.
+extern pl0_parser_t<pl0_ast_assign_stmt *> pl0_assign_stmt;
+extern pl0_parser_t<pl0_ast_function_id *> pl0_function_id;
+extern pl0_parser_t<pl0_ast_expression *> pl0_expression;
+extern pl0_parser_t<pl0_ast_term *> pl0_term;
+extern pl0_parser_t<pl0_ast_factor *> pl0_factor;
+extern pl0_parser_t<pl0_ast_call_func *> pl0_call_func;
+extern pl0_parser_t<pl0_ast_arg_list *> pl0_arg_list;
+extern pl0_parser_t<pl0_ast_arg *> pl0_arg;
+extern pl0_parser_t<pl0_ast_addop *> pl0_addop;
+extern pl0_parser_t<pl0_ast_multop *> pl0_multop;
+extern pl0_parser_t<pl0_ast_condtion *> pl0_condition;
+extern pl0_parser_t<pl0_ast_comp_op *> pl0_comp_op;
+extern pl0_parser_t<pl0_ast_cond_stmt *> pl0_cond_stmt;
+extern pl0_parser_t<pl0_ast_case_stmt *> pl0_case_stmt;
+extern pl0_parser_t<pl0_ast_case_term *> pl0_case_term;
+extern pl0_parser_t<pl0_ast_for_stmt *> pl0_for_stmt;
+extern pl0_parser_t<pl0_ast_call_proc *> pl0_call_proc;
+extern pl0_parser_t<pl0_ast_compound_stmt *> pl0_compound_stmt;
+extern pl0_parser_t<pl0_ast_read_stmt *> pl0_read_stmt;
+extern pl0_parser_t<pl0_ast_write_stmt *> pl0_write_stmt;
 extern parser_t<pl0_ast_alnum *> pl0_alpha;
 extern parser_t<pl0_ast_alnum *> pl0_digit;
+void pl0_resolve_program(pl0_ast_program const *program);
 
 // Test parser for PL0 grammar.
 
@@ -133,13 +135,14 @@ TEST(PL0Parser, pl0_identify) {
 
     auto res1 = parse_tool(new input_t("integer "));
     EXPECT_EQ(res1.status, false);
+    EXPECT_EQ(res1.actual, nullptr); // no node for a failed match.
 
     auto res2 = parse_tool(new input_t("charc;"));
     EXPECT_EQ(res2.status, true);
-    EXPECT_EQ(res2.actual->id, "charc");
+    EXPECT_EQ(res2.actual->id.str(), "charc");
 
     EXPECT_EQ(parse_tool(new input_t("xxxxxxxxxxxxx")).status, true);
-    EXPECT_EQ(parse_tool(new input_t("xxxxxxxxxxxxx=")).actual->id, "xxxxxxxxxxxxx");
+    EXPECT_EQ(parse_tool(new input_t("xxxxxxxxxxxxx=")).actual->id.str(), "xxxxxxxxxxxxx");
 }
 
 TEST(PL0Parser, pl0_primitive_type) {
@@ -147,11 +150,11 @@ TEST(PL0Parser, pl0_primitive_type) {
 
     auto res1 = parse_tool(new input_t("integer"));
     EXPECT_EQ(res1.status, true);
-    EXPECT_EQ(res1.actual->type, "integer");
+    EXPECT_EQ(res1.actual->dt.kind, pl0_type_t::INTEGER);
 
     auto res2 = parse_tool(new input_t("char"));
     EXPECT_EQ(res2.status, true);
-    EXPECT_EQ(res2.actual->type, "char");
+    EXPECT_EQ(res2.actual->dt.kind, pl0_type_t::CHAR);
 
     EXPECT_EQ(parse_tool(new input_t("xxxxxxxxxxxxx")).status, false);
 }
@@ -161,16 +164,16 @@ TEST(PL0Parser, pl0_type) {
 
     auto res1 = parse_tool(new input_t("integer; const;"));
     EXPECT_EQ(res1.status, true);
-    EXPECT_EQ(res1.actual->type->type, "integer");
+    EXPECT_EQ(res1.actual->type->dt.kind, pl0_type_t::INTEGER);
 
     auto res2 = parse_tool(new input_t("array [124] of integer"));
     EXPECT_EQ(res2.status, true);
-    EXPECT_EQ(res2.actual->type->type, "integer");
+    EXPECT_EQ(res2.actual->type->dt.kind, pl0_type_t::INTEGER);
     EXPECT_EQ(res2.actual->len, 124);
 
     auto res3 = parse_tool(new input_t("array [  0 ] of char"));
     EXPECT_EQ(res3.status, true);
-    EXPECT_EQ(res3.actual->type->type, "char");
+    EXPECT_EQ(res3.actual->type->dt.kind, pl0_type_t::CHAR);
     EXPECT_EQ(res3.actual->len, 0);
     EXPECT_EQ(res3.len, 20);
 }
@@ -180,14 +183,14 @@ TEST(PL0Parser, pl0_var_define) {
 
     auto res1 = parse_tool(new input_t("x, y, z: integer;"));
     EXPECT_EQ(res1.status, true);
-    EXPECT_EQ(res1.actual->type->type->type, "integer");
+    EXPECT_EQ(res1.actual->type->type->dt.kind, pl0_type_t::INTEGER);
     EXPECT_EQ(res1.actual->ids.size(), (size_t)3);
 
     auto res2 = parse_tool(new input_t("k, x, y: array [177] of char"));
     EXPECT_EQ(res2.status, true);
-    EXPECT_EQ(res2.actual->type->type->type, "char");
+    EXPECT_EQ(res2.actual->type->type->dt.kind, pl0_type_t::CHAR);
     EXPECT_EQ(res2.actual->type->len, 177);
-    EXPECT_EQ(res2.actual->ids[1]->id, "x");
+    EXPECT_EQ(res2.actual->ids[1]->id.str(), "x");
 
     auto res3 = parse_tool(new input_t("x, y, z: array [177] off char"));
     EXPECT_EQ(res3.status, false);
@@ -198,17 +201,17 @@ TEST(PL0Parser, pl0_var_stmt) {
 
     auto res1 = parse_tool(new input_t("var x, y, z: integer;"));
     EXPECT_EQ(res1.status, true);
-    EXPECT_EQ(res1.actual->stmt[0]->type->type->type, "integer");
+    EXPECT_EQ(res1.actual->stmt[0]->type->type->dt.kind, pl0_type_t::INTEGER);
     EXPECT_EQ(res1.actual->stmt[0]->ids.size(), (size_t)3);
 
     auto res2 = parse_tool(new input_t("var k, x, y: array [177] of char; kk, xx, yy: integer;"));
     EXPECT_EQ(res2.status, true);
-    EXPECT_EQ(res2.actual->stmt[0]->type->type->type, "char");
+    EXPECT_EQ(res2.actual->stmt[0]->type->type->dt.kind, pl0_type_t::CHAR);
     EXPECT_EQ(res2.actual->stmt[0]->type->len, 177);
-    EXPECT_EQ(res2.actual->stmt[0]->ids[1]->id, "x");
-    EXPECT_EQ(res2.actual->stmt[1]->type->type->type, "integer");
+    EXPECT_EQ(res2.actual->stmt[0]->ids[1]->id.str(), "x");
+    EXPECT_EQ(res2.actual->stmt[1]->type->type->dt.kind, pl0_type_t::INTEGER);
     EXPECT_EQ(res2.actual->stmt[1]->type->len, -1);
-    EXPECT_EQ(res2.actual->stmt[1]->ids[1]->id, "xx");
+    EXPECT_EQ(res2.actual->stmt[1]->ids[1]->id.str(), "xx");
     EXPECT_EQ(res2.actual->stmt[1]->ids.size(), (size_t)3);
 
     auto res3 = parse_tool(new input_t("var x, y, z: array [177] of char"));
@@ -220,17 +223,17 @@ TEST(PL0Parser, pl0_const_define) {
 
     auto res1 = parse_tool(new input_t("x = +1245"));
     EXPECT_EQ(res1.status, true);
-    EXPECT_EQ(res1.actual->id->id, "x");
+    EXPECT_EQ(res1.actual->id->id.str(), "x");
     EXPECT_EQ(res1.actual->val->val, 1245);
 
     auto res2 = parse_tool(new input_t("tt=-12345"));
     EXPECT_EQ(res2.status, true);
-    EXPECT_EQ(res2.actual->id->id, "tt");
+    EXPECT_EQ(res2.actual->id->id.str(), "tt");
     EXPECT_EQ(res2.actual->val->val, -12345);
 
     auto res3 = parse_tool(new input_t("c = 'c'"));
     EXPECT_EQ(res3.status, true);
-    EXPECT_EQ(res3.actual->id->id, "c");
+    EXPECT_EQ(res3.actual->id->id.str(), "c");
     EXPECT_EQ(res3.actual->val->val, (int)'c');
 
     EXPECT_EQ(parse_tool(new input_t("c = c")).status, false);
@@ -242,13 +245,13 @@ TEST(PL0Parser, pl0_const_stmt) {
 
     auto res1 = parse_tool(new input_t("const x = +1245, t = -12456, u = 'c';"));
     EXPECT_TRUE(res1.status);
-    EXPECT_EQ(res1.actual->stmt[0]->id->id, "x");
+    EXPECT_EQ(res1.actual->stmt[0]->id->id.str(), "x");
     EXPECT_EQ(res1.actual->stmt[0]->val->val, 1245);
 
     auto res2 = parse_tool(new input_t("const tt=-12345, x ='c', z = 12;"));
     EXPECT_TRUE(res2.status);
     EXPECT_EQ(res2.actual->stmt.size(), (size_t)3);
-    EXPECT_EQ(res2.actual->stmt[0]->id->id, "tt");
+    EXPECT_EQ(res2.actual->stmt[0]->id->id.str(), "tt");
     EXPECT_EQ(res2.actual->stmt[2]->val->val, 12);
 
     auto res3 = parse_tool(new input_t("const zero = '0', minus = '-';")); // '-' is not a valid <字母>
@@ -278,6 +281,16 @@ TEST(PL0Parser, PL0Factor) {
     EXPECT_EQ(parse_tool(new input_t("a+b")).status, true);
     EXPECT_EQ(parse_tool(new input_t("(a+b)")).status, true);
     EXPECT_EQ(parse_tool(new input_t("(a+b)")).strict, true);
+    EXPECT_EQ(parse_tool(new input_t("+b")).actual, nullptr);
+}
+
+TEST(PL0Parser, CompOp) {
+    auto parse_tool = ParsecT<decltype(pl0_comp_op)>(pl0_comp_op);
+
+    EXPECT_EQ(parse_tool(new input_t("<= 1")).actual->op, pl0_ast_comp_op::LE);
+    EXPECT_EQ(parse_tool(new input_t("<>")).actual->op, pl0_ast_comp_op::NE);
+    EXPECT_EQ(parse_tool(new input_t("= 1")).actual->op, pl0_ast_comp_op::EQ);
+    EXPECT_FALSE(parse_tool(new input_t(":= 1")).status);
 }
 
 TEST(PL0Parser, ConditionStmt) {
@@ -344,12 +357,157 @@ TEST(PL0Parser, CompoundStmt) {
     EXPECT_EQ(parse_tool(new input_t("begin read(aaaa); write(aaaa) write(\"fsdfsd\") end")).status, false);
 }
 
+TEST(PL0Parser, ErrorRecovery) {
+    auto parse_tool = ParsecT<decltype(pl0_prog)>(pl0_prog);
+
+    auto res = parse_tool(new input_t("const a = , b = 2;\nvar x integer; y: integer;\nbegin x := ; y := 1; write(x; read(y) end"));
+    EXPECT_FALSE(res.status);
+    ASSERT_EQ(res.diagnostics.size(), (size_t)4);
+    EXPECT_EQ(res.diagnostics[0].loc, make_pair(1, 7));
+    EXPECT_EQ(res.diagnostics[1].message, "invalid variable definition");
+    EXPECT_EQ(res.diagnostics[2].loc, make_pair(3, 7));
+    EXPECT_EQ(res.diagnostics[3].loc, make_pair(3, 22));
+}
+
+TEST(PL0Parser, Location) {
+    auto parse_tool = ParsecT<decltype(pl0_compound_stmt)>(pl0_compound_stmt);
+
+    input_t text("begin\n  x := 1;\n  write(x)\nend");
+    pl0_source(text);
+    auto res = parse_tool(text);
+    ASSERT_TRUE(res.status);
+    EXPECT_EQ(pl0_locate(res.actual->loc), make_pair(1, 1));
+    EXPECT_EQ(pl0_locate(res.actual->stmt[0]->loc), make_pair(2, 3));
+    EXPECT_EQ(pl0_locate(res.actual->stmt[1]->loc), make_pair(3, 3));
+}
+
+TEST(PL0Parser, Symbols) {
+    pl0_sym_t a = pl0_symbols.intern("abc"), b = pl0_symbols.intern("abc"), c = pl0_symbols.intern("_f_abc");
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.str(), "abc");
+    EXPECT_EQ(pl0_symbols.suffix(c), a);
+    EXPECT_EQ(pl0_symbols.suffix(a), a);
+    EXPECT_TRUE(pl0_sym_t().empty());
+}
+
+TEST(PL0Parser, Env) {
+    pl0_env<constant> env;
+    pl0_sym_t a = pl0_symbols.intern("a"), f = pl0_symbols.intern("f"), fa = pl0_symbols.intern("_f_a");
+    constant res;
+    env.push(constant(a, 1, pl0_type_t::INTEGER));
+    env.tag();
+    EXPECT_FALSE(env.find(a, false));
+    EXPECT_TRUE(env.find(a, true, res));
+    EXPECT_EQ(res.val, 1);
+    env.push(constant(fa, 2, pl0_type_t::INTEGER)); // shadows `a`, found by the suffix of the mangled name.
+    EXPECT_TRUE(env.find(a, false, res));
+    EXPECT_EQ(res.val, 2);
+    EXPECT_EQ(env.depth(a), 1);
+    EXPECT_EQ(env.depth(f), -1);
+    env.detag();
+    EXPECT_TRUE(env.find(a, false, res));
+    EXPECT_EQ(res.val, 1);
+    EXPECT_EQ(env.depth(a), 0);
+    EXPECT_FALSE(env.find(fa, true));
+}
+
+TEST(PL0Parser, Arena) {
+    pl0_ast_arena arena;
+    pl0_ast_identify *id = arena.make<pl0_ast_identify>(0, "abc");
+    pl0_ast_constv *v = arena.make<pl0_ast_constv>(4, 10, pl0_ast_constv::INT);
+    EXPECT_EQ(id->id.str(), "abc");
+    EXPECT_EQ(v->val, 10);
+    EXPECT_EQ((size_t)((char *)v - (char *)id) % alignof(std::max_align_t), (size_t)0);
+    EXPECT_GE(arena.size(), sizeof(pl0_ast_identify) + sizeof(pl0_ast_constv));
+    arena.release();
+    EXPECT_EQ(arena.size(), (size_t)0);
+}
+
 input_t *load_case(char const *fname) {
     std::ifstream t(fname);
     std::string str((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
     return new input_t(str);
 }
 
+TEST(PL0Parser, Resolve) {
+    auto parse_tool = ParsecT<decltype(pl0_program)>(pl0_program);
+    auto res = parse_tool(new input_t("var x: integer;\nfunction f: integer;\nbegin f := x end;\nbegin x := 1 end."));
+    ASSERT_TRUE(res.status);
+    pl0_resolve_program(res.actual);
+    pl0_ast_prog *prog = res.actual->program;
+    pl0_ast_identify *x = prog->vars->stmt[0]->ids[0];
+    EXPECT_EQ(x->binding.kind, pl0_ast_binding::VARIABLE);
+    EXPECT_EQ(x->binding.slot.depth, 1); // the block of the program.
+    EXPECT_EQ(x->binding.slot.offset, -8); // below the display and the saved base pointer.
+    pl0_ast_assign_stmt *outer = dynamic_cast<pl0_ast_assign_stmt *>(prog->stmts->stmt[0]);
+    ASSERT_NE(outer, nullptr);
+    EXPECT_EQ(outer->id->binding.var, x->binding.var); // bound to its declaration.
+    pl0_ast_prog *body = prog->exes[0]->func->funcs[0].second;
+    pl0_ast_assign_stmt *inner = dynamic_cast<pl0_ast_assign_stmt *>(body->stmts->stmt[0]);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(inner->id->binding.kind, pl0_ast_binding::FUNCTION); // sets the retval of `f`.
+    EXPECT_EQ(inner->id->binding.func->name.str(), "_f");
+    EXPECT_EQ(inner->id->binding.slot.depth, 2);
+    EXPECT_EQ(inner->id->binding.slot.offset, -12); // the return value is the first local of `f`.
+}
+
+TEST(PL0Parser, Opcode) {
+    EXPECT_STREQ(TAC::name(TAC::LOAD_ELEM), "=[]");
+    EXPECT_STREQ(TAC::name(TAC::WRITE_E), "write_e");
+    EXPECT_STREQ(TAC::name(TAC::JGE), "jge");
+    EXPECT_EQ(TAC(TAC::JNE, new Value(4, pl0_type_t::INTEGER, Value::LABEL)).str(), "goto jne 4 ");
+    EXPECT_EQ(TAC(TAC::DEF, new Value("a", pl0_type_t::CHAR), nullptr, new Value(10, pl0_type_t::INTEGER)).str(), "def a chararray 10");
+    EXPECT_EQ(TAC(TAC::PARAMREF, new Value("b", pl0_type_t::INTEGER)).str(), "paramref b integer ");
+    EXPECT_EQ(TAC(TAC::ADD, new Value("a", pl0_type_t::INTEGER), new Value("a", pl0_type_t::INTEGER), new Value(1, pl0_type_t::INTEGER)).str(), "+ a a 1");
+}
+
+TEST(PL0Parser, Operand) {
+    Value *a = new Value("a", pl0_type_t::INTEGER), *i = new Value("i", pl0_type_t::INTEGER);
+    Value e(1, pl0_type_t::INTEGER, a, i);
+    EXPECT_EQ(e.t, Value::ELEM);
+    EXPECT_EQ(e.base, a);
+    EXPECT_EQ(e.idx, i);
+    EXPECT_EQ(e.str(), "~t1#a#i#");
+    EXPECT_EQ(Value(3, pl0_type_t::INTEGER, Value::LABEL).str(), "3");
+    EXPECT_FALSE(Value(3, pl0_type_t::INTEGER, Value::LABEL) == Value(3, pl0_type_t::INTEGER));
+    EXPECT_TRUE(Value(1, pl0_type_t::INTEGER, Value::TEMP).named());
+    EXPECT_EQ(Value(1, pl0_type_t::INTEGER, Value::TEMP).str(), "~t1");
+}
+
+TEST(PL0Parser, ValuePool) {
+    pl0_value_pool pool;
+    EXPECT_EQ(pool.imm(1, pl0_type_t::INTEGER), pool.imm(1, pl0_type_t::INTEGER));
+    EXPECT_NE(pool.imm(1, pl0_type_t::INTEGER), pool.imm(1, pl0_type_t::CHAR));
+    EXPECT_EQ(pool.name("x", pl0_type_t::INTEGER), pool.name(pl0_symbols.intern("x"), pl0_type_t::INTEGER));
+    pl0_sym_t x = pl0_symbols.intern("x");
+    EXPECT_EQ(pool.var(x, pl0_type_t::INTEGER, pl0_slot_t(2, -12)), pool.var(x, pl0_type_t::INTEGER, pl0_slot_t(2, -12)));
+    EXPECT_NE(pool.var(x, pl0_type_t::INTEGER, pl0_slot_t(2, 8)), pool.var(x, pl0_type_t::INTEGER, pl0_slot_t(2, 8, true))); // `x` of two procedures.
+    EXPECT_EQ(pool.var(x, pl0_type_t::INTEGER, pl0_slot_t(1, -8))->slot.offset, -8);
+    EXPECT_EQ(pool.label(3), pool.label(3));
+    EXPECT_NE(pool.label(3), pool.imm(3, pl0_type_t::INTEGER));
+    EXPECT_EQ(pool.retype(pool.imm(97, pl0_type_t::CHAR), pl0_type_t::INTEGER), pool.imm(97, pl0_type_t::INTEGER));
+    Value *e = pool.elem(1, pl0_type_t::INTEGER, pool.name("a", pl0_type_t::INTEGER), pool.imm(1, pl0_type_t::INTEGER));
+    EXPECT_EQ(e->str(), "~t1#a#1#");
+    EXPECT_NE(e, pool.elem(1, pl0_type_t::INTEGER, e->base, e->idx)); // not hash-consed.
+    EXPECT_EQ(pool.text("a"), pool.text("a"));
+    EXPECT_NE(pool.text("a"), pool.name("a", pl0_type_t())); // a literal is never an identifier.
+    EXPECT_EQ(pool.text("a")->str(), "a");
+    EXPECT_EQ(pool.mark(Value::AFTER_CALL)->str(), "allsuffix");
+    pool.release();
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST(PL0Parser, Type) {
+    pl0_type_t a(pl0_type_t::CHAR, 10);
+    EXPECT_FALSE(a.scalar());
+    EXPECT_EQ(a.str(), "chararray");
+    EXPECT_EQ(a.elem(), pl0_type_t(pl0_type_t::CHAR));
+    EXPECT_EQ(pl0_type_t(pl0_type_t::INTEGER).byref().str(), "ref_integer");
+    EXPECT_NE(pl0_type_t(pl0_type_t::INTEGER).byref(), pl0_type_t(pl0_type_t::INTEGER));
+    EXPECT_FALSE(pl0_type_t().scalar());
+}
+
 TEST(PL0Parser, FunctionStmt) {
     auto parse_tool = ParsecT<decltype(pl0_function_stmt)>(pl0_function_stmt);
 